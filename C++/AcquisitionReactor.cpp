@@ -0,0 +1,239 @@
+#include "AcquisitionReactor.h"
+#include "Camera.h"
+#include "CameraSystem.h"
+
+#include <algorithm>
+#include <string>
+
+namespace {
+
+// WaitForAny handles at most 64 objects; one is the poller's wake event.
+constexpr std::size_t MaxCamerasPerPoller = 63;
+
+thread_local Camera* currentStrandCamera = nullptr;
+
+void applyReactorThreadSettings(const ThreadSettings& settings, const std::string& defaultName)
+{
+    const auto report = applyCurrentThreadSettings(settings, defaultName);
+    for(const auto& error : report.errors){
+        CameraSystem::syslog("[WARN] Reactor thread " + report.name + ": " + error, true);
+    }
+}
+
+}
+
+AcquisitionReactor::AcquisitionReactor(const AcquisitionReactorOptions& options)
+    : _options(options)
+{
+    const auto pollerCount = std::max<std::size_t>(1, options.pollerThreads);
+    const auto workerCount = std::max<std::size_t>(1, options.workerThreads);
+    for(std::size_t index = 0; index < pollerCount; ++index){
+        _pollers.push_back(std::make_unique<Poller>());
+    }
+    for(std::size_t index = 0; index < pollerCount; ++index){
+        _pollers[index]->thread = std::thread([this, index]{
+            runPoller(index);
+        });
+    }
+    for(std::size_t index = 0; index < workerCount; ++index){
+        _workers.emplace_back([this, index]{
+            runWorker(index);
+        });
+    }
+}
+
+AcquisitionReactor::~AcquisitionReactor()
+{
+    std::vector<Camera*> cameras;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for(const auto& kv : _entries){
+            cameras.push_back(kv.first);
+        }
+    }
+    for(auto* camera : cameras){
+        camera->requestStop();
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _camerasDetached.wait(lock, [this]{ return _entries.empty(); });
+        _stopping = true;
+        for(std::size_t index = 0; index < _pollers.size(); ++index){
+            signalPollerLocked(index);
+        }
+    }
+    _taskAvailable.notify_all();
+
+    for(auto& poller : _pollers){
+        if(poller->thread.joinable()) poller->thread.join();
+    }
+    for(auto& worker : _workers){
+        if(worker.joinable()) worker.join();
+    }
+}
+
+AcquisitionReactorStatistics AcquisitionReactor::statistics() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _statistics;
+}
+
+Camera* AcquisitionReactor::currentCamera() noexcept
+{
+    return currentStrandCamera;
+}
+
+bool AcquisitionReactor::attach(Camera* camera)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if(_stopping || _entries.count(camera) != 0) return false;
+
+    const auto least = std::min_element(_pollers.begin(), _pollers.end(), [](const auto& left, const auto& right){
+        return left->cameraCount < right->cameraCount;
+    });
+    if((*least)->cameraCount >= MaxCamerasPerPoller) return false;
+
+    Entry entry;
+    entry.poller = static_cast<std::size_t>(least - _pollers.begin());
+    ++(*least)->cameraCount;
+    _entries.emplace(camera, entry);
+    _statistics.cameras = _entries.size();
+    signalPollerLocked(entry.poller);
+    return true;
+}
+
+void AcquisitionReactor::wake(Camera* camera)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto iter = _entries.find(camera);
+    if(iter == _entries.end()) return;
+
+    iter->second.wakeRequested = true;
+    if(!iter->second.scheduled){
+        signalPollerLocked(iter->second.poller);
+    }
+}
+
+// A poller only waits on cameras that have no strand task queued or running.
+// Cameras are scheduled exclusively here, so a camera whose session may finish
+// (and whose wait object may go away) is never part of an active wait. A parked
+// camera already holds a result and waits for wake() rather than its wait object.
+void AcquisitionReactor::runPoller(const std::size_t index)
+{
+    applyReactorThreadSettings(_options.poller, "reactor-poll" + std::to_string(index));
+    auto& poller = *_pollers[index];
+    Pylon::WaitObjects waitObjects;
+    std::vector<Camera*> members;
+
+    while(true){
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if(_stopping) break;
+            if(poller.dirty){
+                poller.dirty = false;
+                poller.wakeEvent.Reset();
+                waitObjects.RemoveAll();
+                members.clear();
+                waitObjects.Add(poller.wakeEvent);
+                for(auto& kv : _entries){
+                    auto& entry = kv.second;
+                    if(entry.poller != index || entry.scheduled) continue;
+                    if(entry.wakeRequested){
+                        scheduleLocked(kv.first, entry);
+                        continue;
+                    }
+                    if(entry.parked) continue;
+                    waitObjects.Add(kv.first->grabResultWaitObject());
+                    members.push_back(kv.first);
+                }
+            }
+        }
+
+        unsigned int signalled = 0;
+        const bool woken = waitObjects.WaitForAny(1000, &signalled);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if(_stopping) break;
+        if(!woken){
+            // Idle second: let every camera, parked ones included, sample stream
+            // statistics and notice a lost device even though no result arrived.
+            for(auto& kv : _entries){
+                if(kv.second.poller == index && !kv.second.scheduled){
+                    scheduleLocked(kv.first, kv.second);
+                }
+            }
+            poller.dirty = true;
+            continue;
+        }
+
+        ++_statistics.wakeups;
+        if(signalled == 0 || signalled > members.size()) continue;
+        auto* camera = members[signalled - 1];
+        const auto iter = _entries.find(camera);
+        if(iter != _entries.end() && !iter->second.scheduled){
+            scheduleLocked(camera, iter->second);
+        }
+        poller.dirty = true;
+    }
+}
+
+void AcquisitionReactor::runWorker(const std::size_t index)
+{
+    applyReactorThreadSettings(_options.worker, "reactor-work" + std::to_string(index));
+
+    while(true){
+        Camera* camera = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _taskAvailable.wait(lock, [this]{ return _stopping || !_tasks.empty(); });
+            if(_tasks.empty()) break;
+            camera = _tasks.front();
+            _tasks.pop_front();
+            ++_statistics.tasks;
+        }
+
+        currentStrandCamera = camera;
+        const auto result = camera->drainGrabResults(std::max<std::size_t>(1, _options.drainBudget));
+        currentStrandCamera = nullptr;
+
+        const bool finished = result == Camera::DrainResult::Finished;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            const auto iter = _entries.find(camera);
+            if(iter != _entries.end()){
+                const auto poller = iter->second.poller;
+                if(finished){
+                    --_pollers[poller]->cameraCount;
+                    _entries.erase(iter);
+                    _statistics.cameras = _entries.size();
+                    if(_entries.empty()) _camerasDetached.notify_all();
+                }else{
+                    iter->second.scheduled = false;
+                    iter->second.parked = result == Camera::DrainResult::Parked;
+                }
+                signalPollerLocked(poller);
+            }
+        }
+        // Last access: the camera may be re-armed or destroyed once this returns.
+        if(finished){
+            camera->finishReactorSession();
+        }
+    }
+}
+
+void AcquisitionReactor::scheduleLocked(Camera* camera, Entry& entry)
+{
+    entry.scheduled = true;
+    entry.wakeRequested = false;
+    entry.parked = false;
+    _tasks.push_back(camera);
+    _statistics.maxQueueDepth = std::max(_statistics.maxQueueDepth, _tasks.size());
+    _taskAvailable.notify_one();
+}
+
+void AcquisitionReactor::signalPollerLocked(const std::size_t index)
+{
+    _pollers[index]->dirty = true;
+    _pollers[index]->wakeEvent.Signal();
+}
@@ -0,0 +1,117 @@
+#ifndef ACQUISITIONREACTOR_H
+#define ACQUISITIONREACTOR_H
+
+/**
+ * @file AcquisitionReactor.h
+ * @brief Shared receive threads for many grabbing cameras.
+ *
+ * Poller threads wait on the grab-result wait objects of many cameras at once.
+ * A camera with ready results is handed to a fixed worker pool as a strand:
+ * at most one task per camera is queued or running, so its frames are
+ * processed in order, and the camera is removed from the wait set until the
+ * task finishes. The task queue is bounded by the number of attached cameras.
+ */
+
+#include "ThreadSettings.h"
+
+#include <pylon/PylonIncludes.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class Camera;
+
+struct AcquisitionReactorOptions
+{
+    /** Threads waiting on wait objects; each handles up to 63 cameras. */
+    std::size_t pollerThreads = 1;
+    /** Threads retrieving results and running frame callbacks. */
+    std::size_t workerThreads = 2;
+    /** Results one task processes before yielding to other cameras. */
+    std::size_t drainBudget = 8;
+    /** Poller settings; the default name is `reactor-poll<N>`. */
+    ThreadSettings poller;
+    /** Worker settings; the default name is `reactor-work<N>`. */
+    ThreadSettings worker;
+};
+
+struct AcquisitionReactorStatistics
+{
+    std::size_t cameras = 0;
+    /** Wait-object wake-ups across all pollers. */
+    std::uint64_t wakeups = 0;
+    /** Strand tasks run by the worker pool. */
+    std::uint64_t tasks = 0;
+    std::size_t maxQueueDepth = 0;
+};
+
+class AcquisitionReactor
+{
+public:
+    explicit AcquisitionReactor(const AcquisitionReactorOptions& options);
+    /** Requests stop on every attached camera, waits for their sessions, and joins all threads. */
+    ~AcquisitionReactor();
+
+    AcquisitionReactor(const AcquisitionReactor&) = delete;
+    AcquisitionReactor& operator=(const AcquisitionReactor&) = delete;
+
+    [[nodiscard]] const AcquisitionReactorOptions& options() const noexcept { return _options; }
+    [[nodiscard]] AcquisitionReactorStatistics statistics() const;
+
+    /** Camera whose strand the calling worker thread is running, or null. */
+    static Camera* currentCamera() noexcept;
+
+private:
+    friend class Camera;
+
+    // Poller-visible state of one camera; guarded by _mutex.
+    struct Entry
+    {
+        std::size_t poller = 0;
+        bool scheduled = false;
+        bool wakeRequested = false;
+        // Waiting for a consumer credit: left out of the wait set until wake().
+        bool parked = false;
+    };
+
+    struct Poller
+    {
+        Poller() : wakeEvent(Pylon::WaitObjectEx::Create()) {}
+
+        Pylon::WaitObjectEx wakeEvent;
+        bool dirty = true;
+        std::size_t cameraCount = 0;
+        std::thread thread;
+    };
+
+    /** Starts polling a camera that has just started grabbing; `false` when every poller is full. */
+    bool attach(Camera* camera);
+    /** Asks the poller to schedule `camera` even without a new result, e.g. after a stop request or a returned credit. */
+    void wake(Camera* camera);
+
+    void runPoller(std::size_t index);
+    void runWorker(std::size_t index);
+    void scheduleLocked(Camera* camera, Entry& entry);
+    void signalPollerLocked(std::size_t index);
+
+    const AcquisitionReactorOptions _options;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _taskAvailable;
+    std::condition_variable _camerasDetached;
+    std::unordered_map<Camera*, Entry> _entries;
+    std::deque<Camera*> _tasks;
+    std::vector<std::unique_ptr<Poller>> _pollers;
+    std::vector<std::thread> _workers;
+    bool _stopping = false;
+    AcquisitionReactorStatistics _statistics;
+};
+
+#endif // ACQUISITIONREACTOR_H
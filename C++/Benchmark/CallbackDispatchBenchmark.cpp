@@ -0,0 +1,160 @@
+/**
+ * @file CallbackDispatchBenchmark.cpp
+ * @brief Compares per-frame callback dispatch cost of the snapshot registry with
+ *        the previous lock-and-copy dispatch.
+ *
+ * Runs 1 to 32 subscribers at paced frame rates of 1 to 5 kHz and reports the
+ * mean, p99, and maximum dispatch time. A background thread re-registers one
+ * callback at 10 Hz so registry writes overlap the measured dispatches.
+ *
+ * Usage: CameraCallbackDispatchBenchmark [milliseconds-per-case]
+ */
+
+#include "CallbackRegistry.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct FramePayload
+{
+    const std::uint8_t* data = nullptr;
+    std::size_t size = 0;
+};
+
+using FrameCallback = std::function<void(const FramePayload&, std::size_t)>;
+
+// Reproduces the dispatch that copied every callback under the registry mutex.
+class LockedCopyRegistry
+{
+public:
+    std::size_t add(FrameCallback cb)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto id = _nextId++;
+        _callbacks.emplace(id, std::move(cb));
+        return id;
+    }
+
+    bool remove(const std::size_t id)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _callbacks.erase(id) > 0;
+    }
+
+    void dispatch(const FramePayload& payload, const std::size_t frame)
+    {
+        std::vector<FrameCallback> callbacks;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            callbacks.reserve(_callbacks.size());
+            for(auto& kv : _callbacks){
+                callbacks.push_back(kv.second);
+            }
+        }
+        for(auto& cb : callbacks){
+            if(cb) cb(payload, frame);
+        }
+    }
+
+private:
+    std::mutex _mutex;
+    std::unordered_map<std::size_t, FrameCallback> _callbacks;
+    std::size_t _nextId = 1;
+};
+
+struct Result
+{
+    double meanNs = 0.0;
+    double p99Ns = 0.0;
+    double maxNs = 0.0;
+};
+
+template<typename Registry>
+Result runCase(const std::size_t subscribers, const int rateHz, const std::chrono::milliseconds duration)
+{
+    Registry registry;
+    std::atomic<std::uint64_t> sink{0};
+    // Captures sized like a typical consumer closure so copies are not free.
+    struct Capture { std::uint64_t tag[4]; };
+    for(std::size_t index = 0; index < subscribers; ++index){
+        const Capture capture{{index, index + 1, index + 2, index + 3}};
+        registry.add([&sink, capture](const FramePayload& payload, const std::size_t frame){
+            sink.fetch_add(payload.size + frame + capture.tag[0], std::memory_order_relaxed);
+        });
+    }
+
+    std::atomic<bool> running{true};
+    std::thread writer([&]{
+        while(running.load(std::memory_order_acquire)){
+            const auto id = registry.add([](const FramePayload&, std::size_t){});
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            registry.remove(id);
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+    });
+
+    std::vector<std::uint8_t> pixels(4096);
+    const FramePayload payload{pixels.data(), pixels.size()};
+    const auto period = std::chrono::nanoseconds(1000000000LL / rateHz);
+    const auto frames = static_cast<std::size_t>(duration / period);
+    std::vector<double> samples;
+    samples.reserve(frames);
+
+    auto next = std::chrono::steady_clock::now();
+    for(std::size_t frame = 0; frame < frames; ++frame){
+        next += period;
+        std::this_thread::sleep_until(next);
+        const auto started = std::chrono::steady_clock::now();
+        registry.dispatch(payload, frame);
+        samples.push_back(static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - started).count()));
+    }
+
+    running.store(false, std::memory_order_release);
+    writer.join();
+
+    Result result;
+    if(samples.empty()) return result;
+    std::sort(samples.begin(), samples.end());
+    double total = 0.0;
+    for(const auto sample : samples) total += sample;
+    result.meanNs = total / static_cast<double>(samples.size());
+    result.p99Ns = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+    result.maxNs = samples.back();
+    return result;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    const auto duration = std::chrono::milliseconds(argc > 1 ? std::max(10, std::atoi(argv[1])) : 250);
+
+    std::printf("%-12s %-8s %14s %14s %14s %14s %14s %14s\n",
+                "subscribers", "rateHz",
+                "locked-mean", "locked-p99", "locked-max",
+                "snapshot-mean", "snapshot-p99", "snapshot-max");
+    for(const std::size_t subscribers : {1u, 2u, 4u, 8u, 16u, 32u}){
+        for(const int rateHz : {1000, 2000, 5000}){
+            const auto locked = runCase<LockedCopyRegistry>(subscribers, rateHz, duration);
+            const auto snapshot = runCase<CallbackRegistry<FrameCallback>>(subscribers, rateHz, duration);
+            std::printf("%-12zu %-8d %12.0fns %12.0fns %12.0fns %12.0fns %12.0fns %12.0fns\n",
+                        subscribers, rateHz,
+                        locked.meanNs, locked.p99Ns, locked.maxNs,
+                        snapshot.meanNs, snapshot.p99Ns, snapshot.maxNs);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,175 @@
+#ifndef CALLBACKREGISTRY_H
+#define CALLBACKREGISTRY_H
+
+/**
+ * @file CallbackRegistry.h
+ * @brief Copy-on-write callback registry with lock-free, allocation-free dispatch.
+ *
+ * Registration publishes a new immutable snapshot through an atomic pointer swap.
+ * Dispatch reads the current snapshot without locking, allocating, or copying
+ * callbacks; retired snapshots are reclaimed by a later writer once no dispatch
+ * is in flight.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+template<typename Callback>
+class CallbackRegistry
+{
+public:
+    using Id = std::size_t;
+
+    CallbackRegistry() = default;
+    ~CallbackRegistry()
+    {
+        delete _snapshot.load(std::memory_order_acquire);
+    }
+
+    CallbackRegistry(const CallbackRegistry&) = delete;
+    CallbackRegistry& operator=(const CallbackRegistry&) = delete;
+
+    /**
+     * @brief Adds a callback and publishes a new snapshot.
+     * @return Identifier greater than zero, or zero when `cb` is empty.
+     */
+    Id add(Callback cb)
+    {
+        if(!cb) return 0;
+
+        std::lock_guard<std::mutex> lock(_writerMutex);
+        const Id id = _nextId++;
+        auto next = copyCurrentLocked();
+        next->entries.push_back({id, std::move(cb)});
+        publishLocked(std::move(next));
+        return id;
+    }
+
+    /** Removes one callback; a dispatch already in flight may still invoke it once. */
+    bool remove(const Id id)
+    {
+        std::lock_guard<std::mutex> lock(_writerMutex);
+        const auto* current = _snapshot.load(std::memory_order_acquire);
+        if(!current) return false;
+
+        auto next = std::make_unique<Snapshot>();
+        next->entries.reserve(current->entries.size());
+        bool removed = false;
+        for(const auto& entry : current->entries){
+            if(entry.id == id){
+                removed = true;
+                continue;
+            }
+            next->entries.push_back(entry);
+        }
+        if(!removed) return false;
+
+        publishLocked(next->entries.empty() ? nullptr : std::move(next));
+        return true;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(_writerMutex);
+        publishLocked(nullptr);
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return _snapshot.load(std::memory_order_acquire) == nullptr;
+    }
+
+    /** Invokes every callback of the current snapshot with the same arguments. */
+    template<typename... Args>
+    void dispatch(const Args&... args) const
+    {
+        const ReaderScope scope(_readers);
+        const auto* snapshot = _snapshot.load(std::memory_order_seq_cst);
+        if(!snapshot) return;
+
+        for(const auto& entry : snapshot->entries){
+            entry.callback(args...);
+        }
+    }
+
+    /** Like `dispatch()`, and calls `completed(id)` after each callback returns. */
+    template<typename Completed, typename... Args>
+    void dispatchObserved(Completed&& completed, const Args&... args) const
+    {
+        const ReaderScope scope(_readers);
+        const auto* snapshot = _snapshot.load(std::memory_order_seq_cst);
+        if(!snapshot) return;
+
+        for(const auto& entry : snapshot->entries){
+            entry.callback(args...);
+            completed(entry.id);
+        }
+    }
+
+private:
+    struct Entry
+    {
+        Id id;
+        Callback callback;
+    };
+
+    struct Snapshot
+    {
+        std::vector<Entry> entries;
+    };
+
+    class ReaderScope
+    {
+    public:
+        explicit ReaderScope(std::atomic<std::size_t>& readers) noexcept : _readers(readers)
+        {
+            _readers.fetch_add(1, std::memory_order_seq_cst);
+        }
+        ~ReaderScope()
+        {
+            _readers.fetch_sub(1, std::memory_order_release);
+        }
+
+        ReaderScope(const ReaderScope&) = delete;
+        ReaderScope& operator=(const ReaderScope&) = delete;
+
+    private:
+        std::atomic<std::size_t>& _readers;
+    };
+
+    std::unique_ptr<Snapshot> copyCurrentLocked() const
+    {
+        auto next = std::make_unique<Snapshot>();
+        if(const auto* current = _snapshot.load(std::memory_order_acquire)){
+            next->entries.reserve(current->entries.size() + 1);
+            next->entries = current->entries;
+        }
+        return next;
+    }
+
+    // A reader announces itself before loading the snapshot pointer, so once the
+    // swap is visible and the reader count is zero no dispatch can still hold a
+    // retired snapshot. Otherwise reclamation waits for a later writer.
+    void publishLocked(std::unique_ptr<Snapshot> next)
+    {
+        const auto* previous = _snapshot.exchange(next.release(), std::memory_order_seq_cst);
+        if(previous){
+            _retired.emplace_back(previous);
+        }
+        if(_readers.load(std::memory_order_seq_cst) == 0){
+            _retired.clear();
+        }
+    }
+
+    mutable std::atomic<std::size_t> _readers{0};
+    std::atomic<const Snapshot*> _snapshot{nullptr};
+    std::mutex _writerMutex;
+    std::vector<std::unique_ptr<const Snapshot>> _retired;
+    Id _nextId = 1;
+};
+
+#endif // CALLBACKREGISTRY_H
@@ -1,5 +1,8 @@
 #include "Camera.h"
+#include "AcquisitionReactor.h"
 #include "CameraSystem.h"
+#include "Logger.h"
+#include "TraceRecorder.h"
 
 #include <pylon/ConfigurationHelper.h>
 
@@ -7,58 +10,13 @@
 #include <cctype>
 #include <chrono>
 #include <exception>
-#include <initializer_list>
 #include <limits>
 #include <optional>
+#include <stdexcept>
 #include <string>
 
 namespace {
 
-template<typename Callback>
-using CallbackRegistry = std::unordered_map<size_t, Callback>;
-
-template<typename Callback>
-size_t registerCallback(std::mutex& mutex, CallbackRegistry<Callback>& registry, std::atomic<size_t>& nextId, Callback cb)
-{
-    if(!cb) return 0;
-
-    std::lock_guard<std::mutex> lock(mutex);
-    const size_t id = nextId++;
-    registry.emplace(id, std::move(cb));
-    return id;
-}
-
-template<typename Callback>
-bool deregisterCallback(std::mutex& mutex, CallbackRegistry<Callback>& registry, size_t id)
-{
-    std::lock_guard<std::mutex> lock(mutex);
-    return registry.erase(id) > 0;
-}
-
-template<typename Callback>
-void clearCallbacks(std::mutex& mutex, CallbackRegistry<Callback>& registry)
-{
-    std::lock_guard<std::mutex> lock(mutex);
-    registry.clear();
-}
-
-template<typename Callback, typename... Args>
-void dispatchCallbacks(std::mutex& mutex, CallbackRegistry<Callback>& registry, Args&&... args)
-{
-    std::vector<Callback> callbacks;
-    {
-        std::lock_guard<std::mutex> lock(mutex);
-        callbacks.reserve(registry.size());
-        for(auto& kv : registry){
-            callbacks.push_back(kv.second);
-        }
-    }
-
-    for(auto& cb : callbacks){
-        if(cb) cb(std::forward<Args>(args)...);
-    }
-}
-
 string toLowerCopy(string value)
 {
     std::transform(value.begin(), value.end(), value.begin(), [](unsigned char ch){
@@ -69,7 +27,7 @@ string toLowerCopy(string value)
 
 std::string enableComponent(GenApi::INodeMap& nodeMap,
                             const char* componentName,
-                            const std::initializer_list<const char*> pixelFormats = {},
+                            const std::vector<std::string>& pixelFormats = {},
                             const char* sourceName = nullptr)
 {
     auto* componentSelectorNode = nodeMap.GetNode("ComponentSelector");
@@ -93,8 +51,8 @@ std::string enableComponent(GenApi::INodeMap& nodeMap,
     if(pixelFormatNode && GenApi::IsReadable(pixelFormatNode)){
         auto pixelFormatParam = Pylon::CEnumParameter(nodeMap, "PixelFormat");
         if(GenApi::IsWritable(pixelFormatNode)){
-            for(const char* pixelFormat : pixelFormats){
-                if(pixelFormatParam.TrySetValue(pixelFormat)) break;
+            for(const auto& pixelFormat : pixelFormats){
+                if(pixelFormatParam.TrySetValue(pixelFormat.c_str())) break;
             }
         }
         return pixelFormatParam.GetValue().c_str();
@@ -108,6 +66,13 @@ std::optional<double> readFloatParameter(GenApi::INodeMap& nodeMap, const char*
     auto* node = nodeMap.GetNode(name);
     if(!node || !GenApi::IsReadable(node)) return std::nullopt;
     return Pylon::CFloatParameter(nodeMap, name).GetValue();
+}
+
+std::optional<int64_t> readIntegerParameter(GenApi::INodeMap& nodeMap, const char* name)
+{
+    auto* node = nodeMap.GetNode(name);
+    if(!node || !GenApi::IsReadable(node)) return std::nullopt;
+    return Pylon::CIntegerParameter(nodeMap, name).GetValue();
 }
 
 bool isColorPixelFormat(const std::string& value)
@@ -229,6 +194,104 @@ bool setComponentMappingMode(GenApi::INodeMap& nodeMap, const char* mappingMode)
         && Pylon::CEnumParameter(nodeMap, "BslComponentMappingMode").TrySetValue(mappingMode);
 }
 
+Pylon::EGrabStrategy toPylonGrabStrategy(const Camera::GrabOptions::Strategy strategy, const bool triggerMode)
+{
+    switch(strategy){
+    case Camera::GrabOptions::Strategy::OneByOne:
+        return GrabStrategy_OneByOne;
+    case Camera::GrabOptions::Strategy::LatestImageOnly:
+        return GrabStrategy_LatestImageOnly;
+    case Camera::GrabOptions::Strategy::LatestImages:
+        return GrabStrategy_LatestImages;
+    case Camera::GrabOptions::Strategy::UpcomingImage:
+        return GrabStrategy_UpcomingImage;
+    case Camera::GrabOptions::Strategy::Auto:
+        break;
+    }
+    return triggerMode ? GrabStrategy_OneByOne : GrabStrategy_LatestImageOnly;
+}
+
+const char* grabStrategyName(const Pylon::EGrabStrategy strategy)
+{
+    switch(strategy){
+    case GrabStrategy_OneByOne:
+        return "OneByOne";
+    case GrabStrategy_LatestImageOnly:
+        return "LatestImageOnly";
+    case GrabStrategy_LatestImages:
+        return "LatestImages";
+    case GrabStrategy_UpcomingImage:
+        return "UpcomingImage";
+    }
+    return "Unknown";
+}
+
+size_t capBufferCountToMemory(const size_t count, const Camera::GrabOptions& options, const int64_t payloadSize)
+{
+    if(options.bufferMemoryCap == 0 || payloadSize <= 0) return count;
+    const auto affordable = options.bufferMemoryCap / static_cast<size_t>(payloadSize);
+    return std::max<size_t>(1, std::min(count, affordable));
+}
+
+// Grows the pool when the transport lost frames for lack of buffers, otherwise
+// shrinks halfway toward twice the deepest ready-queue backlog seen in the run.
+size_t nextTunedBufferCount(const Camera::GrabOptions& options,
+                            const size_t armedCount,
+                            const int64_t lostFrames,
+                            const int64_t peakReadyBuffers)
+{
+    auto next = armedCount;
+    if(lostFrames > 0){
+        next = armedCount * 2;
+    }else{
+        const auto needed = static_cast<size_t>(2 * (std::max<int64_t>(peakReadyBuffers, 0) + 1));
+        if(needed < armedCount){
+            next = armedCount - (armedCount - needed + 1) / 2;
+        }
+    }
+    const auto minimum = std::max<size_t>(1, options.minBufferCount);
+    const auto maximum = std::max(minimum, options.maxBufferCount);
+    return std::clamp(next, minimum, maximum);
+}
+
+// Number of block IDs missing between two consecutive results. GigE Vision 1.x
+// block IDs are 16 bit and wrap from 65535 to 1; a backwards step only counts as
+// that wrap when both IDs lie within `BlockIdWrapWindow` of it. Any other
+// backwards step is a stream restart and is not counted.
+constexpr uint64_t BlockIdWrapWindow = 1024;
+
+uint64_t blockIdGap(const uint64_t previous, const uint64_t current)
+{
+    if(current > previous) return current - previous - 1;
+    if(previous <= 0xFFFF && previous > 0xFFFF - BlockIdWrapWindow && current >= 1 && current <= BlockIdWrapWindow){
+        return (0xFFFF - previous) + (current - 1);
+    }
+    return 0;
+}
+
+void applyGrabEngineThreadPriority(GenApi::INodeMap& instantCameraNodeMap,
+                                   const int priority,
+                                   Camera::AcquisitionThreadDiagnostics& diagnostics)
+{
+    try{
+        Pylon::CBooleanParameter overrideParameter(instantCameraNodeMap, "InternalGrabEngineThreadPriorityOverride");
+        Pylon::CIntegerParameter priorityParameter(instantCameraNodeMap, "InternalGrabEngineThreadPriority");
+        if(!overrideParameter.IsWritable() || !priorityParameter.IsWritable()){
+            diagnostics.grabEngineError = "InternalGrabEngineThreadPriority is not writable";
+            return;
+        }
+        overrideParameter.SetValue(true);
+        priorityParameter.SetValue(priority);
+        diagnostics.grabEngineThreadPriority = priorityParameter.GetValue();
+        diagnostics.grabEnginePriorityApplied = true;
+    }catch(const Pylon::GenericException& e){
+        diagnostics.grabEngineError = e.GetDescription();
+    }
+    if(!diagnostics.grabEngineError.empty()){
+        CameraSystem::syslog("[WARN] Grab engine thread priority not applied: " + diagnostics.grabEngineError, true);
+    }
+}
+
 std::string safeCameraName(Pylon::CInstantCamera& camera, const std::string& fallback)
 {
     if(!fallback.empty()) return fallback;
@@ -240,6 +303,57 @@ std::string safeCameraName(Pylon::CInstantCamera& camera, const std::string& fal
     }
 }
 
+// With a cached layout, only the pixel format that worked last time is tried.
+// When the camera rejects it, the defaults are tried and `cacheReused` is cleared.
+std::string enableLayoutComponent(GenApi::INodeMap& nodeMap,
+                                  const DeviceProfile* cached,
+                                  std::vector<DeviceProfile::Component>& layout,
+                                  bool& cacheReused,
+                                  const char* componentName,
+                                  const std::vector<std::string>& defaults = {})
+{
+    std::string format;
+    const auto* component = cached ? cached->component(componentName) : nullptr;
+    if(component && !component->pixelFormat.empty()){
+        format = enableComponent(nodeMap, componentName, {component->pixelFormat});
+        if(format != component->pixelFormat){
+            cacheReused = false;
+            format = enableComponent(nodeMap, componentName, defaults);
+        }
+    }else{
+        if(cached && !component) cacheReused = false;
+        format = enableComponent(nodeMap, componentName, defaults);
+    }
+    layout.push_back({componentName, format});
+    return format;
+}
+
+// Focal length, principal point, and coordinate scale follow binning, ROI, and
+// depth range, so a cached calibration is only reused while they read back the same.
+// These four reads are the cost of every stereo cache hit; baseline and offset are skipped.
+bool runtimeCalibrationMatches(GenApi::INodeMap& nodeMap, const PylonScene3DProfile& cached, const double defaultScale)
+{
+    return readFloatParameter(nodeMap, "Scan3dFocalLength").value_or(0.0) == cached.focalLength
+        && readFloatParameter(nodeMap, "Scan3dPrincipalPointU").value_or(0.0) == cached.principalPointU
+        && readFloatParameter(nodeMap, "Scan3dPrincipalPointV").value_or(0.0) == cached.principalPointV
+        && readFloatParameter(nodeMap, "Scan3dCoordinateScale").value_or(defaultScale) == cached.coordinateScale;
+}
+
+DeviceProfileKey makeDeviceProfileKey(Pylon::CBaslerUniversalInstantCamera& camera)
+{
+    DeviceProfileKey key;
+    auto& nodeMap = camera.GetNodeMap();
+    key.serialNumber = camera.GetDeviceInfo().GetSerialNumber().c_str();
+    auto* firmwareNode = nodeMap.GetNode("DeviceFirmwareVersion");
+    if(firmwareNode && GenApi::IsReadable(firmwareNode)){
+        key.firmwareVersion = Pylon::CStringParameter(nodeMap, "DeviceFirmwareVersion").GetValue().c_str();
+    }else{
+        key.firmwareVersion = camera.GetDeviceInfo().GetDeviceVersion().c_str();
+    }
+    key.nodeMapHash = hashNodeMap(nodeMap);
+    return key;
+}
+
 void applyGenDcContainerDefaults(GenApi::INodeMap& nodeMap, GenApi::INodeMap& instantCameraNodeMap)
 {
     auto* genDCStreamingModeNode = nodeMap.GetNode("GenDCStreamingMode");
@@ -255,15 +369,61 @@ void applyGenDcContainerDefaults(GenApi::INodeMap& nodeMap, GenApi::INodeMap& in
 
 }
 
-Camera::Camera(CameraSystem *parent, const int allottedNumber) : _system(parent), _allottedNumber(allottedNumber)
+Camera::Camera(CameraSystem *parent, const int allottedNumber)
+    : _system(parent)
+    , _allottedNumber(allottedNumber)
+    , _stopEvent(WaitObjectEx::Create())
+    , _parameterWriter([this]() -> GenApi::INodeMap* {
+          return isOpened() ? &_currentCamera.GetNodeMap() : nullptr;
+      },
+      "cam" + std::to_string(allottedNumber) + "-param",
+      [this](const std::string& feature){ return _parameterCache.node(feature); },
+      [this](const std::vector<GenApi::INode*>& applied){ refreshCachedParameters(applied); })
 {
+    _metrics = registerMetrics(allottedNumber);
     _currentCamera.RegisterConfiguration(this, RegistrationMode_ReplaceAll, Pylon::Cleanup_None);
+}
+
+Camera::Metrics Camera::registerMetrics(const int allottedNumber)
+{
+    auto& registry = MetricsRegistry::instance();
+    const MetricLabels labels{{"camera", std::to_string(allottedNumber)}};
+    Metrics metrics;
+    metrics.framesDelivered = registry.counter("camera_frames_delivered_total",
+        "Frames handed to callbacks and the pull ring.", labels);
+    metrics.framesFailed = registry.counter("camera_frames_failed_total",
+        "Grab results that did not succeed, including incomplete buffers.", labels);
+    metrics.framesDropped = registry.counter("camera_frames_dropped_total",
+        "Frames missing from the block-ID sequence, lost on the transport or skipped on the host.", labels);
+    metrics.frameRate = registry.gauge("camera_fps",
+        "Delivered frames per second over the last sample interval.", labels);
+    metrics.pullQueueDepth = registry.gauge("camera_pull_queue_depth",
+        "Frames waiting in the pull ring.", labels);
+    metrics.creditsOutstanding = registry.gauge("camera_credits_outstanding",
+        "Free-run frames delivered but not yet returned with ready().", labels);
+    metrics.bufferPoolSize = registry.gauge("camera_buffer_pool_size",
+        "Stream buffers allocated for the current grab.", labels);
+    metrics.bufferPoolReady = registry.gauge("camera_buffer_pool_ready",
+        "Filled buffers waiting to be retrieved.", labels);
+    metrics.bufferPoolQueued = registry.gauge("camera_buffer_pool_queued",
+        "Empty buffers queued to the driver.", labels);
+    metrics.creditWait = registry.histogram("camera_credit_wait_seconds",
+        "Time a free-run frame waited for a consumer credit.",
+        {0.0001, 0.0005, 0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1.0, 5.0}, labels);
+    metrics.callbackLatency = registry.histogram("camera_callback_latency_seconds",
+        "Time spent dispatching one frame to the pull ring and all callbacks.",
+        {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0}, labels);
+    return metrics;
 }
 
 Camera::~Camera()
 {
     try{
+        _parameterWriter.shutdown();
         close();
+        stopDeliveryQueues(_grabDeliveryQueues);
+        stopDeliveryQueues(_grab3DDeliveryQueues);
+        stopDeliveryQueues(_frameDeliveryQueues);
         _currentCamera.DeregisterConfiguration(this);
     }catch(const GenericException &e){
         CameraSystem::syslog(e.GetDescription(), true);
@@ -276,17 +436,17 @@ Camera::~Camera()
 
 Camera::CallbackId Camera::registerStatusCallback(StatusCallback cb)
 {
-    return registerCallback(_statusMutex, _statusObservers, _nextStatusObserverId, std::move(cb));
+    return _statusObservers.add(std::move(cb));
 }
 
 bool Camera::deregisterStatusCallback(CallbackId id)
 {
-    return deregisterCallback(_statusMutex, _statusObservers, id);
+    return _statusObservers.remove(id);
 }
 
 void Camera::clearStatusCallbacks()
 {
-    clearCallbacks(_statusMutex, _statusObservers);
+    _statusObservers.clear();
 }
 
 bool Camera::open(const string& cameraName){
@@ -294,6 +454,7 @@ bool Camera::open(const string& cameraName){
         try{
             requestStop();
             _deviceAvailable.store(false, std::memory_order_release);
+            _parameterCache.detach();
             _streamKind.store(StreamKind::Image2D, std::memory_order_release);
             {
                 std::lock_guard<std::mutex> lock(_scene3DProfileMutex);
@@ -313,24 +474,53 @@ bool Camera::open(const string& cameraName){
         }
     };
 
+    OpenTiming timing;
+    const auto openStarted = std::chrono::steady_clock::now();
+    auto phaseStarted = openStarted;
+    const auto endPhase = [&phaseStarted](std::chrono::microseconds& phase){
+        const auto now = std::chrono::steady_clock::now();
+        phase = std::chrono::duration_cast<std::chrono::microseconds>(now - phaseStarted);
+        phaseStarted = now;
+    };
+    const auto storeTiming = [this, &timing, openStarted]{
+        timing.total = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - openStarted);
+        std::lock_guard<std::mutex> lock(_connectionStateMutex);
+        _openTiming = timing;
+    };
+
     try{
         _deviceAvailable.store(false, std::memory_order_release);
         clearNodeEventHandlers();
         CameraSystem::syslog("Try to open " + (cameraName.empty() ? "any one of the cameras on this system" : cameraName) + ".");
+        timing.failedPhase = "createDevice";
         _currentCamera.Attach(_system->createDevice(cameraName), Cleanup_Delete);
+        endPhase(timing.createDevice);
+        timing.failedPhase = "open";
         _currentCamera.Open();
         if(_currentCamera.IsOpen()){
             markOpened(_currentCamera);
         }
+        endPhase(timing.open);
+        timing.failedPhase = "configure";
         configureStreamForConnectedCamera();
+        _parameterCache.attach(_currentCamera.GetNodeMap());
+        endPhase(timing.configure);
+        timing.failedPhase = "eventHandlers";
         registerNodeEventHandlers();
+        endPhase(timing.eventHandlers);
+        timing.failedPhase.clear();
+        storeTiming();
         return true;
     }catch(const GenericException &e){
+        timing.error = e.GetDescription();
         CameraSystem::syslog(e.GetDescription(), true);
     }catch(const std::exception &e){
+        timing.error = e.what();
         CameraSystem::syslog(e.what(), true);
     }
     cleanupFailedOpen();
+    storeTiming();
     return false;
 }
 
@@ -344,7 +534,10 @@ bool Camera::isOpened() const {
 void Camera::close(){
     try{
         stop();
+        // Taken after stop() so a callback waiting on a write cannot block the join.
+        const auto parameterWritesSuspended = _parameterWriter.suspend();
         _deviceAvailable.store(false, std::memory_order_release);
+        _parameterCache.detach();
         _streamKind.store(StreamKind::Image2D, std::memory_order_release);
         {
             std::lock_guard<std::mutex> lock(_scene3DProfileMutex);
@@ -368,48 +561,274 @@ std::string Camera::getConnectedCameraName() const
     return _connectedCameraName;
 }
 
+Camera::OpenTiming Camera::lastOpenTiming() const
+{
+    std::lock_guard<std::mutex> lock(_connectionStateMutex);
+    return _openTiming;
+}
+
 Camera::CallbackId Camera::registerGrabCallback(GrabCallback cb)
 {
-    return registerCallback(_grabCallbackMutex, _grabCallbacks, _nextGrabCallbackId, std::move(cb));
+    if(!cb) return 0;
+    return _grabCallbacks.add([cb = std::move(cb)](const FrameHandle& frame){
+        cb(frame.image(), frame.sequence());
+    });
+}
+
+Camera::CallbackId Camera::registerGrabCallback(GrabCallback cb, const FrameDeliveryOptions& delivery)
+{
+    if(!cb) return 0;
+    return registerQueuedCallback(_grabCallbacks, _grabDeliveryQueues, [cb = std::move(cb)](const FrameHandle& frame){
+        cb(frame.image(), frame.sequence());
+    }, delivery);
 }
 
 bool Camera::deregisterGrabCallback(const CallbackId id)
 {
-    return deregisterCallback(_grabCallbackMutex, _grabCallbacks, id);
+    const bool removed = _grabCallbacks.remove(id);
+    stopDeliveryQueue(_grabDeliveryQueues, id);
+    return removed;
 }
 
 void Camera::clearGrabCallbacks()
 {
-    clearCallbacks(_grabCallbackMutex, _grabCallbacks);
+    _grabCallbacks.clear();
+    stopDeliveryQueues(_grabDeliveryQueues);
+}
+
+std::optional<FrameDeliveryStatistics> Camera::grabDeliveryStatistics(const CallbackId id) const
+{
+    return deliveryStatistics(_grabDeliveryQueues, id);
 }
 
 Camera::CallbackId Camera::registerGrab3DCallback(Grab3DCallback cb)
 {
-    return registerCallback(_grab3DCallbackMutex, _grab3DCallbacks, _nextGrab3DCallbackId, std::move(cb));
+    if(!cb) return 0;
+    return _grab3DCallbacks.add([cb = std::move(cb)](const FrameHandle& frame){
+        cb(frame.dataContainer(), frame.sequence());
+    });
+}
+
+Camera::CallbackId Camera::registerGrab3DCallback(Grab3DCallback cb, const FrameDeliveryOptions& delivery)
+{
+    if(!cb) return 0;
+    return registerQueuedCallback(_grab3DCallbacks, _grab3DDeliveryQueues, [cb = std::move(cb)](const FrameHandle& frame){
+        cb(frame.dataContainer(), frame.sequence());
+    }, delivery);
 }
 
 bool Camera::deregisterGrab3DCallback(const CallbackId id)
 {
-    return deregisterCallback(_grab3DCallbackMutex, _grab3DCallbacks, id);
+    const bool removed = _grab3DCallbacks.remove(id);
+    stopDeliveryQueue(_grab3DDeliveryQueues, id);
+    return removed;
 }
 
 void Camera::clearGrab3DCallbacks()
 {
-    clearCallbacks(_grab3DCallbackMutex, _grab3DCallbacks);
+    _grab3DCallbacks.clear();
+    stopDeliveryQueues(_grab3DDeliveryQueues);
+}
+
+std::optional<FrameDeliveryStatistics> Camera::grab3DDeliveryStatistics(const CallbackId id) const
+{
+    return deliveryStatistics(_grab3DDeliveryQueues, id);
+}
+
+Camera::CallbackId Camera::registerFrameCallback(FrameCallback cb)
+{
+    return _frameCallbacks.add(std::move(cb));
+}
+
+Camera::CallbackId Camera::registerFrameCallback(FrameCallback cb, const FrameDeliveryOptions& delivery)
+{
+    return registerQueuedCallback(_frameCallbacks, _frameDeliveryQueues, std::move(cb), delivery);
+}
+
+bool Camera::deregisterFrameCallback(const CallbackId id)
+{
+    const bool removed = _frameCallbacks.remove(id);
+    stopDeliveryQueue(_frameDeliveryQueues, id);
+    return removed;
+}
+
+void Camera::clearFrameCallbacks()
+{
+    _frameCallbacks.clear();
+    stopDeliveryQueues(_frameDeliveryQueues);
+}
+
+std::optional<FrameDeliveryStatistics> Camera::frameDeliveryStatistics(const CallbackId id) const
+{
+    return deliveryStatistics(_frameDeliveryQueues, id);
+}
+
+Camera::CallbackId Camera::registerQueuedCallback(CallbackRegistry<FrameCallback>& registry,
+                                                  DeliveryQueues& queues,
+                                                  FrameCallback handler,
+                                                  const FrameDeliveryOptions& delivery)
+{
+    if(!handler) return 0;
+
+    const auto thread = acquisitionThreadOptions().delivery;
+    auto queue = FrameDeliveryQueue::start(std::move(handler), delivery, thread,
+                                           "cam" + std::to_string(_allottedNumber) + "-deliver");
+    std::lock_guard<std::mutex> lock(_deliveryQueueMutex);
+    const auto id = registry.add([this, queue](const FrameHandle& frame){
+        // grab() keeps cameras with Block queues off the reactor; one registered
+        // later must still not stall a shared worker, so it drops instead.
+        static const std::atomic<bool> neverWait{false};
+        queue->push(frame, AcquisitionReactor::currentCamera() == this ? neverWait : _isRunning);
+    });
+    queues.emplace(id, std::move(queue));
+    return id;
+}
+
+bool Camera::hasBlockingDeliveryQueue() const
+{
+    std::lock_guard<std::mutex> lock(_deliveryQueueMutex);
+    for(const auto* queues : {&_grabDeliveryQueues, &_grab3DDeliveryQueues, &_frameDeliveryQueues}){
+        for(const auto& [id, queue] : *queues){
+            if(queue->policy() == FrameDeliveryOptions::Policy::Block) return true;
+        }
+    }
+    return false;
+}
+
+void Camera::stopDeliveryQueue(DeliveryQueues& queues, const CallbackId id)
+{
+    std::shared_ptr<FrameDeliveryQueue> queue;
+    {
+        std::lock_guard<std::mutex> lock(_deliveryQueueMutex);
+        const auto iter = queues.find(id);
+        if(iter == queues.end()) return;
+        queue = std::move(iter->second);
+        queues.erase(iter);
+    }
+    queue->stop();
+}
+
+void Camera::stopDeliveryQueues(DeliveryQueues& queues)
+{
+    DeliveryQueues stopped;
+    {
+        std::lock_guard<std::mutex> lock(_deliveryQueueMutex);
+        stopped.swap(queues);
+    }
+    for(auto& kv : stopped){
+        kv.second->stop();
+    }
+}
+
+std::optional<FrameDeliveryStatistics> Camera::deliveryStatistics(const DeliveryQueues& queues, const CallbackId id) const
+{
+    std::lock_guard<std::mutex> lock(_deliveryQueueMutex);
+    const auto iter = queues.find(id);
+    if(iter == queues.end()) return std::nullopt;
+    return iter->second->statistics();
 }
 
 void Camera::ready()
 {
     if(!_permitBackpressureEnabled.load(std::memory_order_acquire)) return;
 
-    int current = _permits.load(std::memory_order_acquire);
-    while(current < 1 && !_permits.compare_exchange_weak(
-              current,
-              1,
-              std::memory_order_acq_rel,
-              std::memory_order_acquire)){
+    bool parked = false;
+    {
+        std::lock_guard<std::mutex> lock(_permitMutex);
+        if(_outstandingCredits.empty()) return;
+        _outstandingCredits.erase(_outstandingCredits.begin());
+        _metrics.creditsOutstanding->set(static_cast<double>(_outstandingCredits.size()));
+        parked = std::exchange(_creditParked, false);
     }
     _permitCondition.notify_one();
+    if(parked) wakeReactorSession();
+}
+
+void Camera::ready(const size_t frame)
+{
+    if(!_permitBackpressureEnabled.load(std::memory_order_acquire)) return;
+
+    bool parked = false;
+    {
+        std::lock_guard<std::mutex> lock(_permitMutex);
+        const auto iter = std::find(_outstandingCredits.begin(), _outstandingCredits.end(), frame);
+        if(iter == _outstandingCredits.end()){
+            ++_creditStatistics.staleReturns;
+            return;
+        }
+        _outstandingCredits.erase(iter);
+        _metrics.creditsOutstanding->set(static_cast<double>(_outstandingCredits.size()));
+        parked = std::exchange(_creditParked, false);
+    }
+    _permitCondition.notify_one();
+    if(parked) wakeReactorSession();
+}
+
+void Camera::setCreditWindow(const size_t window)
+{
+    _creditWindow.store(std::max<size_t>(1, window), std::memory_order_release);
+}
+
+size_t Camera::creditWindow() const
+{
+    return _creditWindow.load(std::memory_order_acquire);
+}
+
+Camera::CreditStatistics Camera::creditStatistics() const
+{
+    std::lock_guard<std::mutex> lock(_permitMutex);
+    auto statistics = _creditStatistics;
+    statistics.outstanding = _outstandingCredits.size();
+    return statistics;
+}
+
+bool Camera::acquireCredit(const size_t frame)
+{
+    std::unique_lock<std::mutex> lock(_permitMutex);
+    const auto hasCredit = [this]{
+        return !_isRunning.load(std::memory_order_acquire)
+            || _outstandingCredits.size() < _creditStatistics.window;
+    };
+    if(!hasCredit()){
+        CAMERA_TRACE_SCOPE_ARG("credit wait", "frame", frame);
+        const auto waitStarted = std::chrono::steady_clock::now();
+        _permitCondition.wait(lock, hasCredit);
+        const auto blocked = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - waitStarted).count());
+        ++_creditStatistics.waits;
+        _creditStatistics.blockedNanoseconds += blocked;
+        _lossCounters.creditStalls.fetch_add(1, std::memory_order_relaxed);
+        _lossCounters.creditStallNanoseconds.fetch_add(blocked, std::memory_order_relaxed);
+        _creditStatistics.maxBlockedNanoseconds = std::max(_creditStatistics.maxBlockedNanoseconds, blocked);
+    }
+
+    if(!_isRunning.load(std::memory_order_acquire)) return false;
+    _outstandingCredits.push_back(frame);
+    _metrics.creditsOutstanding->set(static_cast<double>(_outstandingCredits.size()));
+    return true;
+}
+
+bool Camera::tryAcquireCredit(const size_t frame)
+{
+    std::lock_guard<std::mutex> lock(_permitMutex);
+    if(!_isRunning.load(std::memory_order_acquire)) return false;
+    if(_outstandingCredits.size() >= _creditStatistics.window){
+        _creditParked = true;
+        return false;
+    }
+    _outstandingCredits.push_back(frame);
+    _metrics.creditsOutstanding->set(static_cast<double>(_outstandingCredits.size()));
+    return true;
+}
+
+void Camera::recordCreditWait(const uint64_t blockedNanoseconds)
+{
+    std::lock_guard<std::mutex> lock(_permitMutex);
+    ++_creditStatistics.waits;
+    _creditStatistics.blockedNanoseconds += blockedNanoseconds;
+    _lossCounters.creditStalls.fetch_add(1, std::memory_order_relaxed);
+    _lossCounters.creditStallNanoseconds.fetch_add(blockedNanoseconds, std::memory_order_relaxed);
+    _creditStatistics.maxBlockedNanoseconds = std::max(_creditStatistics.maxBlockedNanoseconds, blockedNanoseconds);
 }
 
 void Camera::configureStreamForConnectedCamera()
@@ -423,29 +842,107 @@ void Camera::configureStreamForConnectedCamera()
     auto& nodeMap = _currentCamera.GetNodeMap();
     auto& instantCameraNodeMap = _currentCamera.GetInstantCameraNodeMap();
 
+    const auto profileCache = _system->deviceProfileCache();
+    DeviceProfileKey profileKey;
+    std::optional<DeviceProfile> cached;
+    if(profileCache && !_currentCamera.GetDeviceInfo().GetSerialNumber().empty()){
+        profileKey = makeDeviceProfileKey(_currentCamera);
+        cached = profileCache->find(profileKey);
+    }
+    const auto* cachedProfile = cached ? &*cached : nullptr;
+
     const auto deviceClass = _currentCamera.GetDeviceInfo().GetDeviceClass().c_str();
-    const auto family = detect3DDeviceFamily(nodeMap, deviceClass);
+    const auto family = cachedProfile ? cachedProfile->scene3D.family : detect3DDeviceFamily(nodeMap, deviceClass);
     if(family != PylonScene3DProfile::DeviceFamily::StereoMini){
         applyGenDcContainerDefaults(nodeMap, instantCameraNodeMap);
     }
+    std::vector<DeviceProfile::Component> layout;
+    bool profileReused = cachedProfile != nullptr;
     if(family == PylonScene3DProfile::DeviceFamily::StereoAce){
-        configureStereoAceStream(nodeMap);
+        profileReused = configureStereoAceStream(nodeMap, cachedProfile, layout);
     }else if(family == PylonScene3DProfile::DeviceFamily::StereoMini){
-        configureStereoMiniStream(nodeMap);
+        profileReused = configureStereoMiniStream(nodeMap, cachedProfile, layout);
     }else if(family == PylonScene3DProfile::DeviceFamily::Blaze){
-        configureBlazeStream(nodeMap);
+        profileReused = configureBlazeStream(nodeMap, cachedProfile, layout);
+    }
+
+    if(profileCache && !profileKey.serialNumber.empty() && !profileReused){
+        DeviceProfile profile;
+        profile.key = profileKey;
+        profile.scene3D = scene3DProfile();
+        profile.components = std::move(layout);
+        if(!profileCache->store(profile)){
+            CameraSystem::syslog("[WARN] Device profile cache could not be written: " + profileCache->path(), true);
+        }
     }
 
     const auto streamKind = _streamKind.load(std::memory_order_acquire);
+    _chunkMetadataPending.store(false, std::memory_order_release);
+    applyChunkMetadataMode();
     const auto* routeText = streamKind == StreamKind::MultiPart3D ? "3D-only" : "2D";
     const auto modelName = toLowerCopy(_currentCamera.GetDeviceInfo().GetModelName().c_str());
     CameraSystem::syslog("[Info " + to_string(_allottedNumber) + "] model="
                          + modelName
                          + " family=" + deviceFamilyName(family)
-                         + " route=" + routeText);
+                         + " route=" + routeText
+                         + (profileCache ? (profileReused ? " profileCache=hit"
+                                            : cachedProfile ? " profileCache=stale" : " profileCache=miss") : ""));
+}
+
+void Camera::applyChunkMetadataMode()
+{
+    auto& nodeMap = _currentCamera.GetNodeMap();
+    const bool wanted = _chunkMetadataEnabled.load(std::memory_order_acquire)
+        && _streamKind.load(std::memory_order_acquire) == StreamKind::Image2D;
+    if(!wanted){
+        if(_chunkMetadataActive.exchange(false, std::memory_order_acq_rel)){
+            disableChunkMetadata(nodeMap);
+        }
+        return;
+    }
+
+    const auto selectors = enableChunkMetadata(nodeMap);
+    _chunkMetadataActive.store(!selectors.empty(), std::memory_order_release);
+    std::string selectorText;
+    for(const auto& selector : selectors){
+        selectorText += (selectorText.empty() ? "" : ",") + selector;
+    }
+    CameraSystem::syslog("[Info " + to_string(_allottedNumber) + "] chunk metadata="
+                         + (selectors.empty() ? std::string("unsupported") : selectorText));
+}
+
+void Camera::setChunkMetadataEnabled(const bool enabled)
+{
+    // Applied by the next grab() or captureBurst(), which own the device until
+    // StartGrabbing(); checking IsGrabbing() here would race with them.
+    if(_chunkMetadataEnabled.exchange(enabled, std::memory_order_acq_rel) != enabled){
+        _chunkMetadataPending.store(true, std::memory_order_release);
+    }
+}
+
+void Camera::applyPendingChunkMetadataMode()
+{
+    if(!_chunkMetadataPending.exchange(false, std::memory_order_acq_rel)) return;
+    try{
+        applyChunkMetadataMode();
+    }catch(const GenericException &e){
+        CameraSystem::syslog(std::string("[WARN] Chunk mode change failed: ") + e.GetDescription(), true);
+    }
+}
+
+bool Camera::isChunkMetadataEnabled() const
+{
+    return _chunkMetadataEnabled.load(std::memory_order_acquire);
+}
+
+bool Camera::isChunkMetadataActive() const
+{
+    return _chunkMetadataActive.load(std::memory_order_acquire);
 }
 
-void Camera::configureBlazeStream(GenApi::INodeMap& nodeMap)
+bool Camera::configureBlazeStream(GenApi::INodeMap& nodeMap,
+                                  const DeviceProfile* cached,
+                                  std::vector<DeviceProfile::Component>& layout)
 {
     _streamKind.store(StreamKind::MultiPart3D, std::memory_order_release);
 
@@ -459,9 +956,10 @@ void Camera::configureBlazeStream(GenApi::INodeMap& nodeMap)
         Pylon::CConfigurationHelper::DisableAllTriggers(nodeMap);
     }
 
-    enableComponent(nodeMap, "Range", {"Coord3D_ABC32f"});
-    enableComponent(nodeMap, "Intensity", {"Mono16"});
-    enableComponent(nodeMap, "Confidence", {"Confidence16"});
+    bool cacheReused = cached != nullptr;
+    enableLayoutComponent(nodeMap, cached, layout, cacheReused, "Range", {"Coord3D_ABC32f"});
+    enableLayoutComponent(nodeMap, cached, layout, cacheReused, "Intensity", {"Mono16"});
+    enableLayoutComponent(nodeMap, cached, layout, cacheReused, "Confidence", {"Confidence16"});
 
     auto* coordinateSelectorNode = _currentCamera.Scan3dCoordinateSelector.GetNode();
     auto* invalidDataValueNode = _currentCamera.Scan3dInvalidDataValue.GetNode();
@@ -477,157 +975,210 @@ void Camera::configureBlazeStream(GenApi::INodeMap& nodeMap)
     std::lock_guard<std::mutex> lock(_scene3DProfileMutex);
     _scene3DProfile.family = PylonScene3DProfile::DeviceFamily::Blaze;
     _scene3DProfile.geometry = PylonScene3DProfile::GeometryKind::DirectXyzRange;
+    return cacheReused;
 }
 
-void Camera::configureStereoAceStream(GenApi::INodeMap& nodeMap)
+bool Camera::configureStereoAceStream(GenApi::INodeMap& nodeMap,
+                                      const DeviceProfile* cached,
+                                      std::vector<DeviceProfile::Component>& layout)
 {
     _streamKind.store(StreamKind::MultiPart3D, std::memory_order_release);
-    const auto intensityFormat = enableComponent(nodeMap, "Intensity", {"RGB8", "Mono8"});
-    enableComponent(nodeMap, "Disparity", {"Coord3D_C16"});
+    bool cacheReused = cached != nullptr;
+    const auto intensityFormat = enableLayoutComponent(nodeMap, cached, layout, cacheReused, "Intensity", {"RGB8", "Mono8"});
+    enableLayoutComponent(nodeMap, cached, layout, cacheReused, "Disparity", {"Coord3D_C16"});
 
     PylonScene3DProfile profile;
-    profile.family = PylonScene3DProfile::DeviceFamily::StereoAce;
-    profile.geometry = PylonScene3DProfile::GeometryKind::DisparityReconstruction;
-    profile.colorRegisteredToRange = isColorPixelFormat(intensityFormat);
-    profile.coordinateScale = readFloatParameter(nodeMap, "Scan3dCoordinateScale").value_or(0.0);
-    profile.coordinateOffset = readFloatParameter(nodeMap, "Scan3dCoordinateOffset").value_or(0.0);
-    profile.baseline = readFloatParameter(nodeMap, "Scan3dBaseline").value_or(0.0);
-    profile.focalLength = readFloatParameter(nodeMap, "Scan3dFocalLength").value_or(0.0);
-    profile.principalPointU = readFloatParameter(nodeMap, "Scan3dPrincipalPointU").value_or(0.0);
-    profile.principalPointV = readFloatParameter(nodeMap, "Scan3dPrincipalPointV").value_or(0.0);
+    if(cacheReused && runtimeCalibrationMatches(nodeMap, cached->scene3D, 0.0)){
+        profile = cached->scene3D;
+    }else{
+        cacheReused = false;
+        profile.family = PylonScene3DProfile::DeviceFamily::StereoAce;
+        profile.geometry = PylonScene3DProfile::GeometryKind::DisparityReconstruction;
+        profile.colorRegisteredToRange = isColorPixelFormat(intensityFormat);
+        profile.coordinateScale = readFloatParameter(nodeMap, "Scan3dCoordinateScale").value_or(0.0);
+        profile.coordinateOffset = readFloatParameter(nodeMap, "Scan3dCoordinateOffset").value_or(0.0);
+        profile.baseline = readFloatParameter(nodeMap, "Scan3dBaseline").value_or(0.0);
+        profile.focalLength = readFloatParameter(nodeMap, "Scan3dFocalLength").value_or(0.0);
+        profile.principalPointU = readFloatParameter(nodeMap, "Scan3dPrincipalPointU").value_or(0.0);
+        profile.principalPointV = readFloatParameter(nodeMap, "Scan3dPrincipalPointV").value_or(0.0);
+    }
 
     std::lock_guard<std::mutex> lock(_scene3DProfileMutex);
     _scene3DProfile = std::move(profile);
+    return cacheReused;
 }
 
-void Camera::configureStereoMiniStream(GenApi::INodeMap& nodeMap)
+bool Camera::configureStereoMiniStream(GenApi::INodeMap& nodeMap,
+                                       const DeviceProfile* cached,
+                                       std::vector<DeviceProfile::Component>& layout)
 {
     _streamKind.store(StreamKind::MultiPart3D, std::memory_order_release);
-    enableComponent(nodeMap, "Intensity");
-    enableComponent(nodeMap, "Range", {"Coord3D_ABC32f", "Coord3D_C16"});
+    bool cacheReused = cached != nullptr;
+    enableLayoutComponent(nodeMap, cached, layout, cacheReused, "Intensity");
+    enableLayoutComponent(nodeMap, cached, layout, cacheReused, "Range", {"Coord3D_ABC32f", "Coord3D_C16"});
 
     PylonScene3DProfile profile;
-    profile.family = PylonScene3DProfile::DeviceFamily::StereoMini;
-    profile.geometry = PylonScene3DProfile::GeometryKind::DirectXyzRange;
-    profile.colorRegisteredToRange = false;
-    profile.coordinateScale = readFloatParameter(nodeMap, "Scan3dCoordinateScale").value_or(1.0);
-    profile.coordinateOffset = readFloatParameter(nodeMap, "Scan3dCoordinateOffset").value_or(0.0);
-    profile.baseline = readFloatParameter(nodeMap, "Scan3dBaseline").value_or(0.0);
-    profile.focalLength = readFloatParameter(nodeMap, "Scan3dFocalLength").value_or(0.0);
-    profile.principalPointU = readFloatParameter(nodeMap, "Scan3dPrincipalPointU").value_or(0.0);
-    profile.principalPointV = readFloatParameter(nodeMap, "Scan3dPrincipalPointV").value_or(0.0);
+    if(cacheReused && runtimeCalibrationMatches(nodeMap, cached->scene3D, 1.0)){
+        profile = cached->scene3D;
+    }else{
+        cacheReused = false;
+        profile.family = PylonScene3DProfile::DeviceFamily::StereoMini;
+        profile.geometry = PylonScene3DProfile::GeometryKind::DirectXyzRange;
+        profile.colorRegisteredToRange = false;
+        profile.coordinateScale = readFloatParameter(nodeMap, "Scan3dCoordinateScale").value_or(1.0);
+        profile.coordinateOffset = readFloatParameter(nodeMap, "Scan3dCoordinateOffset").value_or(0.0);
+        profile.baseline = readFloatParameter(nodeMap, "Scan3dBaseline").value_or(0.0);
+        profile.focalLength = readFloatParameter(nodeMap, "Scan3dFocalLength").value_or(0.0);
+        profile.principalPointU = readFloatParameter(nodeMap, "Scan3dPrincipalPointU").value_or(0.0);
+        profile.principalPointV = readFloatParameter(nodeMap, "Scan3dPrincipalPointV").value_or(0.0);
+    }
 
     std::lock_guard<std::mutex> lock(_scene3DProfileMutex);
     _scene3DProfile = std::move(profile);
+    return cacheReused;
 }
 
 void Camera::grab(const size_t frames){
+    CAMERA_TRACE_SCOPE("Camera::grab arm");
     try{
         if(!isOpened()) return;
         if(_isRunning.load(std::memory_order_acquire)) return;
+        const auto joinStarted = std::chrono::steady_clock::now();
         if(_thread.joinable()){
-            const auto joinStarted = std::chrono::steady_clock::now();
             _thread.join();
-            const auto joinMs = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::steady_clock::now() - joinStarted).count();
-            if(joinMs >= 100){
-                CameraSystem::syslog("[WARN] Previous camera grab worker join took "
-                    + std::to_string(joinMs) + " ms before re-arm.", true);
-            }
+        }
+        waitForReactorSession();
+        const auto joinMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - joinStarted).count();
+        if(joinMs >= 100){
+            CameraSystem::syslog("[WARN] Previous camera grab worker join took "
+                + std::to_string(joinMs) + " ms before re-arm.", true);
         }
 
+        const auto options = grabOptions();
+        const auto threadOptions = acquisitionThreadOptions();
+        auto reactor = _system->acquisitionReactor();
         const bool triggerMode = _currentCamera.TriggerMode.GetValue()
             == Basler_UniversalCameraParams::TriggerModeEnums::TriggerMode_On;
-        if(triggerMode){
-            _currentCamera.MaxNumBuffer = 30;
-            _currentCamera.StartGrabbing(GrabStrategy_OneByOne, GrabLoop_ProvidedByUser);
-        }else{
-            _currentCamera.MaxNumBuffer = 5;
-            _currentCamera.StartGrabbing(GrabStrategy_LatestImageOnly, GrabLoop_ProvidedByUser);
+        // Free-run credit waits park the strand, but a full Block queue would hold a
+        // shared reactor worker and stall every camera queued behind it.
+        if(reactor && hasBlockingDeliveryQueue()){
+            reactor.reset();
+            if(!_reactorFallbackLogged.exchange(true, std::memory_order_acq_rel)){
+                CameraSystem::syslog("[Info " + to_string(_allottedNumber)
+                    + "] Block delivery queue registered; using a worker thread instead of the acquisition reactor.");
+            }
+        }
+        const auto strategy = toPylonGrabStrategy(options.strategy, triggerMode);
+
+        // Before PayloadSize is read, since the chunks are part of the payload.
+        applyPendingChunkMetadataMode();
+
+        auto bufferCount = options.bufferCount != 0 ? options.bufferCount : size_t(triggerMode ? 30 : 5);
+        const auto tunedCount = _tunedBufferCount.load(std::memory_order_acquire);
+        if(options.autoTuneBuffers && tunedCount != 0){
+            bufferCount = tunedCount;
         }
+        const auto payloadSize = readIntegerParameter(_currentCamera.GetNodeMap(), "PayloadSize").value_or(0);
+        bufferCount = capBufferCountToMemory(bufferCount, options, payloadSize);
+        _currentCamera.MaxNumBuffer = static_cast<int64_t>(bufferCount);
+        if(strategy == GrabStrategy_LatestImages){
+            const auto queueSize = std::clamp<size_t>(options.outputQueueSize, 1, bufferCount);
+            _currentCamera.OutputQueueSize = static_cast<int64_t>(queueSize);
+        }
+
+        GenApi::IInteger* readyBuffersNode = nullptr;
+        if(options.autoTuneBuffers){
+            readyBuffersNode = dynamic_cast<GenApi::IInteger*>(
+                _currentCamera.GetInstantCameraNodeMap().GetNode("NumReadyBuffers"));
+        }
+        const auto streamBaseline = readStreamCounters(_currentCamera.GetStreamGrabberNodeMap());
+
+        AcquisitionThreadDiagnostics threadDiagnostics;
+        if(threadOptions.overrideGrabEngineThreadPriority){
+            applyGrabEngineThreadPriority(_currentCamera.GetInstantCameraNodeMap(),
+                                          threadOptions.grabEngineThreadPriority, threadDiagnostics);
+        }
+        {
+            std::lock_guard<std::mutex> lock(_grabOptionsMutex);
+            _threadDiagnostics = threadDiagnostics;
+        }
+
+        _stopEvent.Reset();
+        _currentCamera.StartGrabbing(strategy, GrabLoop_ProvidedByUser);
 
         _isRunning.store(true, std::memory_order_release);
         _frameTarget.store(frames, std::memory_order_release);
         _frameSeq.store(0, std::memory_order_release);
-        _permits.store(1, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(_permitMutex);
+            _creditStatistics = {};
+            _creditStatistics.window = _creditWindow.load(std::memory_order_acquire);
+            _outstandingCredits.clear();
+            _outstandingCredits.reserve(_creditStatistics.window);
+            _creditParked = false;
+            _metrics.creditsOutstanding->set(0);
+        }
         _permitBackpressureEnabled.store(!triggerMode, std::memory_order_release);
 
-        CameraSystem::syslog("[DEBUG] Grab armed: targetFrames=" + std::to_string(frames)
+        CAMERA_LOG_DEBUG("[DEBUG] Grab armed: targetFrames=" + std::to_string(frames)
             + ", triggerMode=" + (triggerMode ? "On" : "Off")
-            + ", strategy=" + (triggerMode ? "OneByOne" : "LatestImageOnly")
-            + ", receiveLoop=worker-thread.");
-
-        _thread = std::thread([this, triggerMode]{
-            const auto workerStarted = std::chrono::steady_clock::now();
-            auto nextProgressLog = workerStarted + std::chrono::seconds(10);
-            std::chrono::milliseconds maximumCallbackTime{0};
-            std::size_t slowCallbackCount = 0;
-            std::size_t delivered = 0;
+            + ", strategy=" + grabStrategyName(strategy)
+            + ", buffers=" + std::to_string(bufferCount)
+            + ", receiveLoop=" + (reactor ? "reactor." : "worker-thread."));
+
+        auto session = std::make_unique<GrabSession>();
+        session->triggerMode = triggerMode;
+        session->options = options;
+        session->bufferCount = bufferCount;
+        session->readyBuffersNode = readyBuffersNode;
+        session->streamBaseline = streamBaseline;
+        session->streamSample = streamBaseline;
+        session->parseChunks = _chunkMetadataActive.load(std::memory_order_acquire);
+        if(session->parseChunks){
+            session->chunkParser.reset(bufferCount);
+        }
+        session->started = std::chrono::steady_clock::now();
+        session->nextProgressLog = session->started + std::chrono::seconds(10);
+        session->nextStreamSample = session->started + std::chrono::seconds(1);
+        session->rateSampledAt = session->started;
+        _metrics.bufferPoolSize->set(static_cast<double>(bufferCount));
+        _session = std::move(session);
+
+        if(reactor){
+            {
+                std::lock_guard<std::mutex> lock(_sessionMutex);
+                _sessionReactor = reactor.get();
+            }
+            if(reactor->attach(this)) return;
+            finishReactorSession();
+            CAMERA_LOG_RATE_LIMITED(LogLevel::Warning, std::chrono::seconds(10),
+                "[WARN] Acquisition reactor is full; using a worker thread.");
+        }
+
+        _thread = std::thread([this, threadOptions]{
+            const auto threadReport = applyCurrentThreadSettings(threadOptions.worker,
+                "cam" + std::to_string(_allottedNumber) + "-grab");
+            for(const auto& error : threadReport.errors){
+                CameraSystem::syslog("[WARN] Acquisition thread " + threadReport.name + ": " + error, true);
+            }
+            {
+                std::lock_guard<std::mutex> lock(_grabOptionsMutex);
+                _threadDiagnostics.worker = threadReport;
+            }
+
+            auto& session = *_session;
             try{
                 CGrabResultPtr grabResult;
+                const auto waitObjects = makeGrabWaitObjects();
 
                 while(_isRunning.load(std::memory_order_acquire) && _deviceAvailable.load(std::memory_order_acquire) && _currentCamera.IsGrabbing()){
-                    if(_currentCamera.RetrieveResult(1000, grabResult, Pylon::TimeoutHandling_Return)){
-                        if(grabResult->GrabSucceeded()){
-                            if(!triggerMode){
-                                std::unique_lock<std::mutex> lock(_permitMutex);
-                                _permitCondition.wait(lock, [this]{
-                                    return !_isRunning.load(std::memory_order_acquire) || _permits.load(std::memory_order_acquire) > 0;
-                                });
-
-                                if (!_isRunning.load(std::memory_order_acquire)) break;
-                                _permits.fetch_sub(1, std::memory_order_acq_rel);
-                            }
-
-                            auto seq = _frameSeq.fetch_add(1, std::memory_order_acq_rel) + 1;
-                            const auto callbackStarted = std::chrono::steady_clock::now();
-                            if(_streamKind.load(std::memory_order_acquire) == StreamKind::MultiPart3D){
-                                try{
-                                    auto container = grabResult->GetDataContainer();
-                                    dispatchCallbacks(_grab3DCallbackMutex, _grab3DCallbacks, container, seq);
-                                }catch(const GenericException &e){
-                                    CameraSystem::syslog(std::string("[WARN] [Camera System] GetDataContainer exception: ") + e.GetDescription(), true);
-                                }catch(const std::exception &e){
-                                    CameraSystem::syslog(std::string("[WARN] [Camera System] GetDataContainer std::exception: ") + e.what(), true);
-                                }catch(...){
-                                    CameraSystem::syslog("[WARN] [Camera System] GetDataContainer unknown exception", true);
-                                }
-                            }else{
-                                CPylonImage image;
-                                image.AttachGrabResultBuffer(grabResult);
-                                dispatchCallbacks(_grabCallbackMutex, _grabCallbacks, image, seq);
-                            }
-
-                            const auto callbackTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                std::chrono::steady_clock::now() - callbackStarted);
-                            maximumCallbackTime = std::max(maximumCallbackTime, callbackTime);
-                            if(callbackTime >= std::chrono::milliseconds(500)){
-                                ++slowCallbackCount;
-                                if(slowCallbackCount <= 3 || slowCallbackCount % 100 == 0){
-                                    CameraSystem::syslog("[WARN] Grab callback backpressure: frame="
-                                        + std::to_string(seq) + ", callbackMs="
-                                        + std::to_string(callbackTime.count()) + ", slowCount="
-                                        + std::to_string(slowCallbackCount) + ".", true);
-                                }
-                            }
-
-                            ++delivered;
-                            const auto now = std::chrono::steady_clock::now();
-                            if(now >= nextProgressLog){
-                                CameraSystem::syslog("[DEBUG] Grab worker progress: frames="
-                                    + std::to_string(delivered) + ", lastCallbackMs="
-                                    + std::to_string(callbackTime.count()) + ", maxCallbackMs="
-                                    + std::to_string(maximumCallbackTime.count()) + ".");
-                                nextProgressLog = now + std::chrono::seconds(10);
-                            }
-
-                            auto target = _frameTarget.load(std::memory_order_acquire);
-                            if(target !=0 && delivered >= target){
-                                _isRunning.store(false, std::memory_order_release);
-                                _permitCondition.notify_all();
-                                break;
-                            }
-                        }
+                    const auto wait = waitForGrabResult(waitObjects, 1000);
+                    if(wait == GrabWait::Stopped) break;
+                    sampleStreamCountersIfDue(session);
+                    if(wait == GrabWait::Timeout) continue;
+                    if(retrieveGrabResult(grabResult)){
+                        if(!processGrabResult(session, grabResult)) break;
                     }
                 }
             }catch(const GenericException &e){
@@ -637,24 +1188,7 @@ void Camera::grab(const size_t frames){
             }catch(...){
                 CameraSystem::syslog("Unknown exception in Camera::grab thread.", true);
             }
-            _isRunning.store(false, std::memory_order_release);
-            _permitCondition.notify_all();
-            try{
-                if(_currentCamera.IsGrabbing()) _currentCamera.StopGrabbing();
-            }catch(const GenericException &e){
-                CameraSystem::syslog(std::string("[WARN] StopGrabbing cleanup failed: ")
-                    + e.GetDescription(), true);
-            }catch(const std::exception &e){
-                CameraSystem::syslog(std::string("[WARN] StopGrabbing cleanup failed: ")
-                    + e.what(), true);
-            }
-            _permitBackpressureEnabled.store(false, std::memory_order_release);
-            const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::steady_clock::now() - workerStarted).count();
-            CameraSystem::syslog("[DEBUG] Grab worker finished: frames="
-                + std::to_string(delivered) + ", elapsedMs=" + std::to_string(elapsedMs)
-                + ", maxCallbackMs=" + std::to_string(maximumCallbackTime.count())
-                + ", slowCallbacks=" + std::to_string(slowCallbackCount) + ".");
+            finishGrab(session);
         });
     }catch(const GenericException &e){
         _isRunning.store(false, std::memory_order_release);
@@ -675,6 +1209,92 @@ void Camera::grab(const size_t frames){
     }
 }
 
+size_t Camera::captureBurst(const size_t frames, FrameArena& arena, const std::chrono::milliseconds frameTimeout)
+{
+    arena.clear();
+    if(frames == 0 || !isOpened()) return 0;
+    if(_streamKind.load(std::memory_order_acquire) == StreamKind::MultiPart3D){
+        CameraSystem::syslog("[WARN] Burst capture supports 2D streams only.", true);
+        return 0;
+    }
+
+    bool expected = false;
+    if(!_isRunning.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) return 0;
+    if(_thread.joinable()){
+        _thread.join();
+    }
+    // A reactor session still in finishGrab() would otherwise stop the burst's grab.
+    waitForReactorSession();
+
+    const auto burstStarted = std::chrono::steady_clock::now();
+    size_t failed = 0;
+    try{
+        applyPendingChunkMetadataMode();
+        const auto payloadSize = readIntegerParameter(_currentCamera.GetNodeMap(), "PayloadSize").value_or(0);
+        if(payloadSize <= 0 || !arena.reserve(frames, static_cast<size_t>(payloadSize))){
+            throw std::runtime_error("Burst arena allocation failed for " + std::to_string(frames)
+                + " frames of " + std::to_string(payloadSize) + " bytes.");
+        }
+
+        const auto options = grabOptions();
+        auto bufferCount = options.bufferCount != 0 ? options.bufferCount : size_t(30);
+        bufferCount = capBufferCountToMemory(std::min(bufferCount, frames), options, payloadSize);
+        _currentCamera.MaxNumBuffer = static_cast<int64_t>(bufferCount);
+        _stopEvent.Reset();
+        _currentCamera.StartGrabbing(frames, GrabStrategy_OneByOne, GrabLoop_ProvidedByUser);
+
+        CGrabResultPtr grabResult;
+        const auto waitObjects = makeGrabWaitObjects();
+        const auto timeoutMs = static_cast<unsigned int>(std::max<std::chrono::milliseconds::rep>(0, frameTimeout.count()));
+        size_t sequence = 0;
+        std::optional<uint64_t> previousBlockId;
+        while(arena.frameCount() < frames
+              && _isRunning.load(std::memory_order_acquire)
+              && _currentCamera.IsGrabbing()){
+            if(waitForGrabResult(waitObjects, timeoutMs) != GrabWait::Result) break;
+            if(!retrieveGrabResult(grabResult)) continue;
+            const auto received = std::chrono::steady_clock::now();
+            countGrabResult(grabResult, previousBlockId);
+            ++sequence;
+            if(!grabResult->GrabSucceeded()){
+                ++failed;
+                continue;
+            }
+
+            BurstFrameInfo info;
+            info.sequence = sequence;
+            info.blockId = grabResult->GetBlockID();
+            info.deviceTimestamp = grabResult->GetTimeStamp();
+            info.hostTimestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                received.time_since_epoch()).count();
+            info.width = grabResult->GetWidth();
+            info.height = grabResult->GetHeight();
+            info.pixelType = grabResult->GetPixelType();
+            if(!arena.append(grabResult->GetBuffer(), grabResult->GetImageSize(), info)){
+                ++failed;
+            }
+        }
+    }catch(const GenericException &e){
+        CameraSystem::syslog(e.GetDescription(), true);
+    }catch(const std::exception &e){
+        CameraSystem::syslog(std::string("Camera burst capture failed: ") + e.what(), true);
+    }
+
+    try{
+        if(_currentCamera.IsGrabbing()) _currentCamera.StopGrabbing();
+    }catch(const GenericException &e){
+        CameraSystem::syslog(std::string("[WARN] StopGrabbing cleanup failed: ") + e.GetDescription(), true);
+    }
+    _isRunning.store(false, std::memory_order_release);
+
+    const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - burstStarted).count();
+    CAMERA_LOG_DEBUG("[DEBUG] Burst capture finished: frames=" + std::to_string(arena.frameCount())
+        + "/" + std::to_string(frames) + ", failed=" + std::to_string(failed)
+        + ", elapsedMs=" + std::to_string(elapsedMs) + ".");
+    return arena.frameCount();
+}
+
 void Camera::stop(){
     try{
         requestStop();
@@ -684,9 +1304,10 @@ void Camera::stop(){
             _thread.join();
             const auto joinMs = std::chrono::duration_cast<std::chrono::milliseconds>(
                 std::chrono::steady_clock::now() - joinStarted).count();
-            CameraSystem::syslog("[DEBUG] Camera stop joined grab worker in "
+            CAMERA_LOG_DEBUG("[DEBUG] Camera stop joined grab worker in "
                 + std::to_string(joinMs) + " ms.");
         }
+        waitForReactorSession();
     }catch(const GenericException &e){
         CameraSystem::syslog(e.GetDescription(),true);
     }catch(const std::exception &e){
@@ -694,10 +1315,635 @@ void Camera::stop(){
     }
 }
 
+bool Camera::processGrabResult(GrabSession& session, const CGrabResultPtr& grabResult)
+{
+    CAMERA_TRACE_SCOPE("processGrabResult");
+    const auto hostReceiveNs = FrameTiming::now();
+    countGrabResult(grabResult, session.previousBlockId);
+    if(session.readyBuffersNode){
+        session.peakReadyBuffers = std::max(session.peakReadyBuffers, session.readyBuffersNode->GetValue());
+    }
+    if(!grabResult->GrabSucceeded()) return true;
+
+    auto seq = _frameSeq.fetch_add(1, std::memory_order_acq_rel) + 1;
+    if(!session.triggerMode){
+        if(AcquisitionReactor::currentCamera() == this){
+            // A shared worker must not block; the result waits in the session
+            // and the credit returned by ready() wakes this strand again.
+            if(!tryAcquireCredit(seq)){
+                if(!_isRunning.load(std::memory_order_acquire)) return false;
+                session.parkedResult = grabResult;
+                session.parkedSeq = seq;
+                session.parkedReceiveNs = hostReceiveNs;
+                return true;
+            }
+        }else if(!acquireCredit(seq)){
+            return false;
+        }
+    }
+    return deliverGrabResult(session, grabResult, seq, hostReceiveNs);
+}
+
+bool Camera::deliverGrabResult(GrabSession& session, const CGrabResultPtr& grabResult,
+                               const size_t seq, const int64_t hostReceiveNs)
+{
+    const auto creditWaitNs = session.triggerMode ? 0 : FrameTiming::now() - hostReceiveNs;
+    if(!session.triggerMode){
+        _metrics.creditWait->observe(static_cast<double>(creditWaitNs) * 1e-9);
+    }
+
+    const auto callbackStarted = std::chrono::steady_clock::now();
+    if(_streamKind.load(std::memory_order_acquire) == StreamKind::MultiPart3D){
+        try{
+            deliverFrame(FrameHandle(grabResult, seq, true, hostReceiveNs, creditWaitNs));
+        }catch(const GenericException &e){
+            CAMERA_LOG_RATE_LIMITED(LogLevel::Warning, std::chrono::seconds(1),
+                std::string("[WARN] [Camera System] GetDataContainer exception: ") + e.GetDescription());
+        }catch(const std::exception &e){
+            CAMERA_LOG_RATE_LIMITED(LogLevel::Warning, std::chrono::seconds(1),
+                std::string("[WARN] [Camera System] GetDataContainer std::exception: ") + e.what());
+        }catch(...){
+            CAMERA_LOG_RATE_LIMITED(LogLevel::Warning, std::chrono::seconds(1),
+                "[WARN] [Camera System] GetDataContainer unknown exception");
+        }
+    }else{
+        deliverFrame(FrameHandle(grabResult, seq, false, hostReceiveNs, creditWaitNs,
+                                 session.parseChunks ? session.chunkParser.parse(grabResult) : ChunkMetadata{}));
+    }
+
+    const auto callbackTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - callbackStarted);
+    session.maximumCallbackTime = std::max(session.maximumCallbackTime, callbackTime);
+    if(callbackTime >= std::chrono::milliseconds(500)){
+        ++session.slowCallbackCount;
+        if(session.slowCallbackCount <= 3 || session.slowCallbackCount % 100 == 0){
+            CAMERA_LOG_WARN("[WARN] Grab callback backpressure: frame="
+                + std::to_string(seq) + ", callbackMs="
+                + std::to_string(callbackTime.count()) + ", slowCount="
+                + std::to_string(session.slowCallbackCount) + ".");
+        }
+    }
+
+    ++session.delivered;
+    _lossCounters.delivered.fetch_add(1, std::memory_order_relaxed);
+    _metrics.framesDelivered->add();
+    const auto now = std::chrono::steady_clock::now();
+    if(now >= session.nextProgressLog){
+        CAMERA_LOG_DEBUG("[DEBUG] Grab worker progress: frames="
+            + std::to_string(session.delivered) + ", lastCallbackMs="
+            + std::to_string(callbackTime.count()) + ", maxCallbackMs="
+            + std::to_string(session.maximumCallbackTime.count()) + ".");
+        session.nextProgressLog = now + std::chrono::seconds(10);
+    }
+
+    auto target = _frameTarget.load(std::memory_order_acquire);
+    if(target !=0 && session.delivered >= target){
+        _isRunning.store(false, std::memory_order_release);
+        _permitCondition.notify_all();
+        return false;
+    }
+    return true;
+}
+
+void Camera::sampleStreamCountersIfDue(GrabSession& session)
+{
+    const auto now = std::chrono::steady_clock::now();
+    if(now >= session.nextStreamSample){
+        CAMERA_TRACE_SCOPE("stream counter sample");
+        sampleStreamCounters(session.streamSample);
+        sampleRateMetrics(session, now);
+        session.nextStreamSample = now + std::chrono::seconds(1);
+    }
+}
+
+void Camera::sampleRateMetrics(GrabSession& session, const std::chrono::steady_clock::time_point now)
+{
+    const auto elapsed = std::chrono::duration<double>(now - session.rateSampledAt).count();
+    if(elapsed > 0){
+        _metrics.frameRate->set(static_cast<double>(session.delivered - session.rateDelivered) / elapsed);
+    }
+    session.rateDelivered = session.delivered;
+    session.rateSampledAt = now;
+
+    try{
+        auto& nodeMap = _currentCamera.GetInstantCameraNodeMap();
+        _metrics.bufferPoolReady->set(static_cast<double>(readIntegerParameter(nodeMap, "NumReadyBuffers").value_or(0)));
+        _metrics.bufferPoolQueued->set(static_cast<double>(readIntegerParameter(nodeMap, "NumQueuedBuffers").value_or(0)));
+    }catch(const GenericException &e){
+        CAMERA_LOG_RATE_LIMITED(LogLevel::Warning, std::chrono::seconds(10),
+            std::string("[WARN] Buffer pool metrics read failed: ") + e.GetDescription());
+    }
+}
+
+void Camera::finishGrab(GrabSession& session)
+{
+    session.parkedResult.Release();
+    _isRunning.store(false, std::memory_order_release);
+    _permitCondition.notify_all();
+    interruptPullWaiters();
+    if(_deviceAvailable.load(std::memory_order_acquire)){
+        sampleStreamCounters(session.streamSample);
+    }
+    const int64_t lostFrames = (session.streamSample.bufferUnderruns - session.streamBaseline.bufferUnderruns)
+        + (session.streamSample.missedFrames - session.streamBaseline.missedFrames);
+    try{
+        if(_currentCamera.IsGrabbing()) _currentCamera.StopGrabbing();
+    }catch(const GenericException &e){
+        CameraSystem::syslog(std::string("[WARN] StopGrabbing cleanup failed: ")
+            + e.GetDescription(), true);
+    }catch(const std::exception &e){
+        CameraSystem::syslog(std::string("[WARN] StopGrabbing cleanup failed: ")
+            + e.what(), true);
+    }
+    _metrics.frameRate->set(0);
+    _metrics.bufferPoolSize->set(0);
+    _metrics.bufferPoolReady->set(0);
+    _metrics.bufferPoolQueued->set(0);
+    if(session.options.autoTuneBuffers){
+        const auto nextCount = nextTunedBufferCount(session.options, session.bufferCount, lostFrames, session.peakReadyBuffers);
+        _tunedBufferCount.store(nextCount, std::memory_order_release);
+        if(nextCount != session.bufferCount){
+            CAMERA_LOG_DEBUG("[DEBUG] Buffer auto-tune: buffers=" + std::to_string(session.bufferCount)
+                + " -> " + std::to_string(nextCount) + ", lostFrames=" + std::to_string(lostFrames)
+                + ", peakReadyBuffers=" + std::to_string(session.peakReadyBuffers) + ".");
+        }
+    }
+    _permitBackpressureEnabled.store(false, std::memory_order_release);
+    const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - session.started).count();
+    CAMERA_LOG_DEBUG("[DEBUG] Grab worker finished: frames="
+        + std::to_string(session.delivered) + ", elapsedMs=" + std::to_string(elapsedMs)
+        + ", maxCallbackMs=" + std::to_string(session.maximumCallbackTime.count())
+        + ", slowCallbacks=" + std::to_string(session.slowCallbackCount) + ".");
+}
+
+Camera::DrainResult Camera::resumeParkedResult(GrabSession& session)
+{
+    if(!tryAcquireCredit(session.parkedSeq)){
+        return _isRunning.load(std::memory_order_acquire) ? DrainResult::Parked : DrainResult::Finished;
+    }
+    const auto waitEnded = FrameTiming::now();
+    CAMERA_TRACE_EVENT("credit wait", session.parkedReceiveNs, waitEnded, "frame", session.parkedSeq);
+    recordCreditWait(static_cast<uint64_t>(waitEnded - session.parkedReceiveNs));
+
+    const auto grabResult = session.parkedResult;
+    session.parkedResult.Release();
+    return deliverGrabResult(session, grabResult, session.parkedSeq, session.parkedReceiveNs)
+        ? DrainResult::Rearm : DrainResult::Finished;
+}
+
+Camera::DrainResult Camera::drainGrabResults(const size_t budget)
+{
+    auto& session = *_session;
+    bool finished = false;
+    try{
+        sampleStreamCountersIfDue(session);
+        if(session.parkedResult.IsValid()){
+            const auto resumed = resumeParkedResult(session);
+            if(resumed == DrainResult::Parked) return resumed;
+            finished = resumed == DrainResult::Finished;
+        }
+        CGrabResultPtr grabResult;
+        for(size_t retrieved = 0; !finished && retrieved < budget && isSessionLive(); ++retrieved){
+            if(!retrieveGrabResult(grabResult)) break;
+            if(!processGrabResult(session, grabResult)){
+                finished = true;
+                break;
+            }
+            if(session.parkedResult.IsValid()) return DrainResult::Parked;
+        }
+        finished = finished || !isSessionLive();
+    }catch(const GenericException &e){
+        CameraSystem::syslog(e.GetDescription(), true);
+        finished = true;
+    }catch(const std::exception &e){
+        CameraSystem::syslog(e.what(), true);
+        finished = true;
+    }
+    if(!finished) return DrainResult::Rearm;
+
+    finishGrab(session);
+    return DrainResult::Finished;
+}
+
+bool Camera::isSessionLive() const
+{
+    return _isRunning.load(std::memory_order_acquire)
+        && _deviceAvailable.load(std::memory_order_acquire)
+        && _currentCamera.IsGrabbing();
+}
+
+const WaitObject& Camera::grabResultWaitObject()
+{
+    return _currentCamera.GetGrabResultWaitObject();
+}
+
+void Camera::finishReactorSession()
+{
+    {
+        std::lock_guard<std::mutex> lock(_sessionMutex);
+        _sessionReactor = nullptr;
+    }
+    _sessionCondition.notify_all();
+}
+
+void Camera::waitForReactorSession()
+{
+    if(AcquisitionReactor::currentCamera() == this) return;
+    std::unique_lock<std::mutex> lock(_sessionMutex);
+    _sessionCondition.wait(lock, [this]{ return _sessionReactor == nullptr; });
+}
+
+void Camera::countGrabResult(const CGrabResultPtr& result, std::optional<uint64_t>& previousBlockId)
+{
+    _lossCounters.received.fetch_add(1, std::memory_order_relaxed);
+    if(const auto skipped = result->GetNumberOfSkippedImages()){
+        _lossCounters.skippedImages.fetch_add(skipped, std::memory_order_relaxed);
+    }
+    if(!result->GrabSucceeded()){
+        _lossCounters.failedBuffers.fetch_add(1, std::memory_order_relaxed);
+        _metrics.framesFailed->add();
+    }
+
+    const auto blockId = result->GetBlockID();
+    if(blockId == std::numeric_limits<uint64_t>::max()) return;
+    if(previousBlockId){
+        if(const auto gap = blockIdGap(*previousBlockId, blockId)){
+            _lossCounters.blockIdGaps.fetch_add(gap, std::memory_order_relaxed);
+            _metrics.framesDropped->add(gap);
+        }
+    }
+    previousBlockId = blockId;
+}
+
+Camera::StreamCounters Camera::readStreamCounters(GenApi::INodeMap& streamNodeMap)
+{
+    StreamCounters counters;
+    counters.bufferUnderruns = readIntegerParameter(streamNodeMap, "Statistic_Buffer_Underrun_Count").value_or(0);
+    counters.missedFrames = readIntegerParameter(streamNodeMap, "Statistic_Missed_Frame_Count").value_or(0);
+    return counters;
+}
+
+void Camera::sampleStreamCounters(StreamCounters& last)
+{
+    try{
+        const auto current = readStreamCounters(_currentCamera.GetStreamGrabberNodeMap());
+        if(current.bufferUnderruns > last.bufferUnderruns){
+            _lossCounters.bufferUnderruns.fetch_add(
+                static_cast<uint64_t>(current.bufferUnderruns - last.bufferUnderruns), std::memory_order_relaxed);
+        }
+        if(current.missedFrames > last.missedFrames){
+            _lossCounters.missedFrames.fetch_add(
+                static_cast<uint64_t>(current.missedFrames - last.missedFrames), std::memory_order_relaxed);
+        }
+        last = current;
+    }catch(const GenericException &e){
+        CameraSystem::syslog(std::string("[WARN] Stream statistics read failed: ") + e.GetDescription(), true);
+    }
+}
+
+Camera::Statistics Camera::statistics() const
+{
+    Statistics statistics;
+    statistics.received = _lossCounters.received.load(std::memory_order_relaxed);
+    statistics.delivered = _lossCounters.delivered.load(std::memory_order_relaxed);
+    statistics.skippedImages = _lossCounters.skippedImages.load(std::memory_order_relaxed);
+    statistics.blockIdGaps = _lossCounters.blockIdGaps.load(std::memory_order_relaxed);
+    statistics.failedBuffers = _lossCounters.failedBuffers.load(std::memory_order_relaxed);
+    statistics.bufferUnderruns = _lossCounters.bufferUnderruns.load(std::memory_order_relaxed);
+    statistics.missedFrames = _lossCounters.missedFrames.load(std::memory_order_relaxed);
+    statistics.creditStalls = _lossCounters.creditStalls.load(std::memory_order_relaxed);
+    statistics.creditStallNanoseconds = _lossCounters.creditStallNanoseconds.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+void Camera::resetStatistics()
+{
+    _lossCounters.received.store(0, std::memory_order_relaxed);
+    _lossCounters.delivered.store(0, std::memory_order_relaxed);
+    _lossCounters.skippedImages.store(0, std::memory_order_relaxed);
+    _lossCounters.blockIdGaps.store(0, std::memory_order_relaxed);
+    _lossCounters.failedBuffers.store(0, std::memory_order_relaxed);
+    _lossCounters.bufferUnderruns.store(0, std::memory_order_relaxed);
+    _lossCounters.missedFrames.store(0, std::memory_order_relaxed);
+    _lossCounters.creditStalls.store(0, std::memory_order_relaxed);
+    _lossCounters.creditStallNanoseconds.store(0, std::memory_order_relaxed);
+}
+
+bool Camera::executeSoftwareTrigger(const std::chrono::milliseconds readyTimeout)
+{
+    try{
+        if(!isOpened()) return false;
+        if(readyTimeout.count() > 0 && _currentCamera.CanWaitForFrameTriggerReady()){
+            const auto timeoutMs = static_cast<unsigned int>(readyTimeout.count());
+            if(!_currentCamera.WaitForFrameTriggerReady(timeoutMs, Pylon::TimeoutHandling_Return)) return false;
+        }
+        _currentCamera.ExecuteSoftwareTrigger();
+        return true;
+    }catch(const GenericException &e){
+        CameraSystem::syslog(std::string("[WARN] Software trigger failed: ") + e.GetDescription(), true);
+    }
+    return false;
+}
+
+ConfigurationSnapshot Camera::captureConfiguration()
+{
+    try{
+        if(!isOpened()) return {};
+        const auto started = std::chrono::steady_clock::now();
+        // Queued writes land first; the capture moves selectors, so no pass may run beside it.
+        _parameterWriter.flush();
+        const auto parameterWritesSuspended = _parameterWriter.suspend();
+        auto snapshot = ::captureConfiguration(_currentCamera.GetNodeMap());
+        const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started).count();
+        CAMERA_LOG_DEBUG("[DEBUG] Configuration captured: entries=" + std::to_string(snapshot.entries.size())
+            + ", elapsedMs=" + std::to_string(elapsedMs) + ".");
+        return snapshot;
+    }catch(const GenericException &e){
+        CameraSystem::syslog(std::string("[WARN] Configuration capture failed: ") + e.GetDescription(), true);
+    }catch(const std::exception &e){
+        CameraSystem::syslog(std::string("[WARN] Configuration capture failed: ") + e.what(), true);
+    }
+    return {};
+}
+
+ConfigurationApplyReport Camera::applyConfiguration(const ConfigurationSnapshot& snapshot)
+{
+    ConfigurationApplyReport report;
+    try{
+        if(!isOpened() || snapshot.empty()) return report;
+        auto& nodeMap = _currentCamera.GetNodeMap();
+        _parameterWriter.flush();
+        auto parameterWritesSuspended = _parameterWriter.suspend();
+        const auto changed = diffConfiguration(nodeMap, snapshot, report);
+        if(!changed.empty()){
+            const bool wasRunning = _isRunning.load(std::memory_order_acquire);
+            const auto frames = _frameTarget.load(std::memory_order_acquire);
+            if(wasRunning){
+                // Released around stop() so a callback waiting on a write cannot block the join.
+                parameterWritesSuspended.unlock();
+                stop();
+                parameterWritesSuspended.lock();
+            }
+            writeConfiguration(nodeMap, snapshot, changed, report);
+            _parameterCache.refreshAll();
+            parameterWritesSuspended.unlock();
+            // A finite grab resumes with the frames it still owed, not the whole target.
+            const size_t delivered = wasRunning && _session ? _session->delivered : 0;
+            if(wasRunning && (frames == 0 || delivered < frames)){
+                grab(frames == 0 ? 0 : frames - delivered);
+                report.grabRestarted = true;
+            }
+        }
+    }catch(const GenericException &e){
+        CameraSystem::syslog(std::string("[WARN] Configuration apply failed: ") + e.GetDescription(), true);
+    }catch(const std::exception &e){
+        CameraSystem::syslog(std::string("[WARN] Configuration apply failed: ") + e.what(), true);
+    }
+    CAMERA_LOG_DEBUG("[DEBUG] Configuration applied: compared=" + std::to_string(report.compared)
+        + ", written=" + std::to_string(report.written)
+        + ", failed=" + std::to_string(report.failed)
+        + ", notComparable=" + std::to_string(report.notComparable)
+        + ", selectorWrites=" + std::to_string(report.selectorWrites)
+        + ", compareUs=" + std::to_string(report.compareTime.count())
+        + ", writeUs=" + std::to_string(report.writeTime.count()) + ".");
+    for(const auto& feature : report.failedFeatures){
+        CameraSystem::syslog("[WARN] Configuration apply could not write " + feature + ".", true);
+    }
+    for(const auto& feature : report.notComparableFeatures){
+        CameraSystem::syslog("[WARN] Configuration apply could not compare " + feature + ".", true);
+    }
+    return report;
+}
+
+std::future<ParameterWriteResult> Camera::writeCachedParameter(const CachedParameter parameter, const double value)
+{
+    const auto feature = _parameterCache.featureName(parameter);
+    if(feature.empty()){
+        std::promise<ParameterWriteResult> unavailable;
+        ParameterWriteResult result;
+        result.error = "Parameter is not available on this camera.";
+        unavailable.set_value(std::move(result));
+        return unavailable.get_future();
+    }
+    return _parameterWriter.write(feature, ParameterWriter::Value(value));
+}
+
+WaitObjects Camera::makeGrabWaitObjects()
+{
+    // Index order must match GrabWait handling in waitForGrabResult().
+    WaitObjects waitObjects;
+    waitObjects.Add(_currentCamera.GetGrabResultWaitObject());
+    waitObjects.Add(_stopEvent);
+    waitObjects.Add(_currentCamera.GetGrabStopWaitObject());
+    return waitObjects;
+}
+
+Camera::GrabWait Camera::waitForGrabResult(const WaitObjects& waitObjects, const unsigned int timeoutMs)
+{
+    CAMERA_TRACE_SCOPE("RetrieveResult wait");
+    unsigned int signalled = 0;
+    if(!waitObjects.WaitForAny(timeoutMs, &signalled)) return GrabWait::Timeout;
+    return signalled == 0 ? GrabWait::Result : GrabWait::Stopped;
+}
+
+bool Camera::retrieveGrabResult(CGrabResultPtr& grabResult)
+{
+    CAMERA_TRACE_SCOPE("RetrieveResult");
+    return _currentCamera.RetrieveResult(0, grabResult, Pylon::TimeoutHandling_Return);
+}
+
+void Camera::wakeReactorSession()
+{
+    std::lock_guard<std::mutex> lock(_sessionMutex);
+    if(_sessionReactor){
+        _sessionReactor->wake(this);
+    }
+}
+
 void Camera::requestStop()
 {
     _isRunning.store(false, std::memory_order_release);
+    _stopEvent.Signal();
+    wakeReactorSession();
     _permitCondition.notify_all();
+    interruptPullWaiters();
+
+    std::lock_guard<std::mutex> lock(_deliveryQueueMutex);
+    for(const auto* queues : {&_grabDeliveryQueues, &_grab3DDeliveryQueues, &_frameDeliveryQueues}){
+        for(const auto& kv : *queues){
+            kv.second->wakeProducer();
+        }
+    }
+}
+
+bool Camera::enablePullMode(const size_t capacity)
+{
+    if(_isRunning.load(std::memory_order_acquire)) return false;
+    bool replacing = false;
+    if(!_pullReplacing.compare_exchange_strong(replacing, true, std::memory_order_seq_cst)) return false;
+
+    // A consumer may still be inside waitForFrame() or tryPopFrame(): new ones
+    // are turned away above, and the waiting one is woken and leaves.
+    _pullEnabled.store(false, std::memory_order_release);
+    interruptPullWaiters();
+    while(_pullConsumers.load(std::memory_order_seq_cst) != 0){
+        std::this_thread::yield();
+    }
+    _pullRing = std::make_unique<SpscRing<FrameHandle>>(std::max<size_t>(1, capacity));
+    _pullPushed.store(0, std::memory_order_relaxed);
+    _pullPopped.store(0, std::memory_order_relaxed);
+    _pullOverflows.store(0, std::memory_order_relaxed);
+    _metrics.pullQueueDepth->set(0);
+    _pullReplacing.store(false, std::memory_order_release);
+    _pullEnabled.store(true, std::memory_order_release);
+    return true;
+}
+
+void Camera::disablePullMode()
+{
+    _pullEnabled.store(false, std::memory_order_release);
+    interruptPullWaiters();
+}
+
+bool Camera::isPullModeEnabled() const
+{
+    return _pullEnabled.load(std::memory_order_acquire);
+}
+
+bool Camera::tryPopFrame(FrameHandle& frame)
+{
+    if(!enterPullConsumer()) return false;
+    const PullConsumerScope consumer{_pullConsumers};
+    return popPullFrame(frame);
+}
+
+FrameHandle Camera::waitForFrame(const std::chrono::milliseconds timeout)
+{
+    FrameHandle frame;
+    if(!enterPullConsumer()) return frame;
+    const PullConsumerScope consumer{_pullConsumers};
+    if(!_pullRing) return frame;
+    if(popPullFrame(frame)) return frame;
+
+    const auto interrupts = _pullInterrupts.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(_pullMutex);
+    _pullConsumerWaiting.store(true, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    _pullCondition.wait_for(lock, timeout, [this, &frame, interrupts]{
+        return popPullFrame(frame)
+            || _pullInterrupts.load(std::memory_order_acquire) != interrupts
+            || _pullReplacing.load(std::memory_order_acquire);
+    });
+    _pullConsumerWaiting.store(false, std::memory_order_relaxed);
+    return frame;
+}
+
+Camera::PullStatistics Camera::pullStatistics() const
+{
+    PullStatistics statistics;
+    if(enterPullConsumer()){
+        const PullConsumerScope consumer{_pullConsumers};
+        if(_pullRing){
+            statistics.capacity = _pullRing->capacity();
+            statistics.depth = _pullRing->size();
+        }
+    }
+    statistics.pushed = _pullPushed.load(std::memory_order_relaxed);
+    statistics.popped = _pullPopped.load(std::memory_order_relaxed);
+    statistics.overflows = _pullOverflows.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+void Camera::deliverFrame(const FrameHandle& frame)
+{
+    CAMERA_TRACE_SCOPE_ARG("deliverFrame", "frame", frame.sequence());
+    const auto dispatchStartNs = FrameTiming::now();
+    frame.recordDispatchStart(dispatchStartNs);
+    // Callbacks run back to back, so each one starts where the previous one ended.
+    auto callbackStartNs = dispatchStartNs;
+    if(_pullEnabled.load(std::memory_order_acquire)){
+        CAMERA_TRACE_SCOPE("pull push");
+        pushPullFrame(frame);
+        if constexpr(TraceRecorder::CompiledIn) callbackStartNs = FrameTiming::now();
+    }
+    // Each registry numbers its callbacks from 1, so the source and the trace event name tell them apart.
+    const auto recordCallbackEnd = [&frame, &callbackStartNs](const FrameTiming::CallbackSource source, const char* traceName){
+        return [&frame, &callbackStartNs, source, traceName](const CallbackId id){
+            const auto endNs = FrameTiming::now();
+            frame.recordCallbackEnd(source, id, endNs);
+            CAMERA_TRACE_EVENT(traceName, callbackStartNs, endNs, "id", id);
+            callbackStartNs = endNs;
+        };
+    };
+    if(frame.isMultiPart()){
+        _grab3DCallbacks.dispatchObserved(recordCallbackEnd(FrameTiming::CallbackSource::Grab3D, "grab3D callback"), frame);
+    }else{
+        _grabCallbacks.dispatchObserved(recordCallbackEnd(FrameTiming::CallbackSource::Grab, "grab callback"), frame);
+    }
+    _frameCallbacks.dispatchObserved(recordCallbackEnd(FrameTiming::CallbackSource::Frame, "frame callback"), frame);
+
+    const auto dispatchEndNs = FrameTiming::now();
+    frame.recordDispatchEnd(dispatchEndNs);
+    _latencyHistogram.record(dispatchEndNs - frame.timing().hostReceiveNs);
+    _metrics.callbackLatency->observe(static_cast<double>(dispatchEndNs - dispatchStartNs) * 1e-9);
+}
+
+const LatencyHistogram& Camera::latencyHistogram() const
+{
+    return _latencyHistogram;
+}
+
+void Camera::resetLatencyHistogram()
+{
+    _latencyHistogram.reset();
+}
+
+bool Camera::enterPullConsumer() const
+{
+    // Pairs with enablePullMode(): either it sees this consumer or the consumer sees the replacement.
+    _pullConsumers.fetch_add(1, std::memory_order_seq_cst);
+    if(!_pullReplacing.load(std::memory_order_seq_cst)) return true;
+    _pullConsumers.fetch_sub(1, std::memory_order_release);
+    return false;
+}
+
+bool Camera::popPullFrame(FrameHandle& frame)
+{
+    if(!_pullRing || !_pullRing->tryPop(frame)) return false;
+    _pullPopped.fetch_add(1, std::memory_order_relaxed);
+    _metrics.pullQueueDepth->set(static_cast<double>(_pullRing->size()));
+    return true;
+}
+
+void Camera::pushPullFrame(const FrameHandle& frame)
+{
+    if(!_pullRing->tryPush(frame)){
+        _pullOverflows.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    _pullPushed.fetch_add(1, std::memory_order_relaxed);
+    _metrics.pullQueueDepth->set(static_cast<double>(_pullRing->size()));
+
+    // Pairs with the fence in waitForFrame(): either the consumer sees the new
+    // frame before sleeping or the producer sees it waiting and notifies.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(_pullConsumerWaiting.load(std::memory_order_relaxed)){
+        {
+            std::lock_guard<std::mutex> lock(_pullMutex);
+        }
+        _pullCondition.notify_one();
+    }
+}
+
+void Camera::interruptPullWaiters()
+{
+    {
+        std::lock_guard<std::mutex> lock(_pullMutex);
+        _pullInterrupts.fetch_add(1, std::memory_order_acq_rel);
+    }
+    _pullCondition.notify_all();
 }
 
 std::vector<string> Camera::getUpdatedCameraList() const {
@@ -712,6 +1958,46 @@ GenApi::INodeMap &Camera::getNodeMap(){
     return _currentCamera.GetNodeMap();
 }
 
+void Camera::setGrabOptions(const GrabOptions& options)
+{
+    std::lock_guard<std::mutex> lock(_grabOptionsMutex);
+    const bool tuningChanged = options.autoTuneBuffers != _grabOptions.autoTuneBuffers
+        || options.bufferCount != _grabOptions.bufferCount;
+    _grabOptions = options;
+    if(tuningChanged){
+        _tunedBufferCount.store(0, std::memory_order_release);
+    }
+}
+
+Camera::GrabOptions Camera::grabOptions() const
+{
+    std::lock_guard<std::mutex> lock(_grabOptionsMutex);
+    return _grabOptions;
+}
+
+size_t Camera::tunedBufferCount() const
+{
+    return _tunedBufferCount.load(std::memory_order_acquire);
+}
+
+void Camera::setAcquisitionThreadOptions(const AcquisitionThreadOptions& options)
+{
+    std::lock_guard<std::mutex> lock(_grabOptionsMutex);
+    _threadOptions = options;
+}
+
+Camera::AcquisitionThreadOptions Camera::acquisitionThreadOptions() const
+{
+    std::lock_guard<std::mutex> lock(_grabOptionsMutex);
+    return _threadOptions;
+}
+
+Camera::AcquisitionThreadDiagnostics Camera::acquisitionThreadDiagnostics() const
+{
+    std::lock_guard<std::mutex> lock(_grabOptionsMutex);
+    return _threadDiagnostics;
+}
+
 PylonScene3DProfile Camera::scene3DProfile() const
 {
     std::lock_guard<std::mutex> lock(_scene3DProfileMutex);
@@ -720,17 +2006,17 @@ PylonScene3DProfile Camera::scene3DProfile() const
 
 Camera::CallbackId Camera::registerNodeUpdatedCallback(NodeCallback cb)
 {
-    return registerCallback(_nodeCallbackMutex, _nodeCallbacks, _nextNodeCallbackId, std::move(cb));
+    return _nodeCallbacks.add(std::move(cb));
 }
 
 bool Camera::deregisterNodeUpdatedCallback(const CallbackId id)
 {
-    return deregisterCallback(_nodeCallbackMutex, _nodeCallbacks, id);
+    return _nodeCallbacks.remove(id);
 }
 
 void Camera::clearNodeUpdatedCallbacks()
 {
-    clearCallbacks(_nodeCallbackMutex, _nodeCallbacks);
+    _nodeCallbacks.clear();
 }
 
 void Camera::OnAttached(CInstantCamera &camera){
@@ -749,8 +2035,8 @@ void Camera::OnDestroyed(CInstantCamera &camera){
     _deviceAvailable.store(false, std::memory_order_release);
     auto from = "[Info " + to_string(_allottedNumber)  +"] ";
     CameraSystem::syslog(from + "Device destroyed.");
-    dispatchCallbacks(_statusMutex, _statusObservers, GrabbingStatus, false);
-    dispatchCallbacks(_statusMutex, _statusObservers, ConnectionStatus, false);
+    _statusObservers.dispatch(GrabbingStatus, false);
+    _statusObservers.dispatch(ConnectionStatus, false);
 }
 
 void Camera::OnOpened(CInstantCamera &camera){
@@ -763,10 +2049,11 @@ void Camera::OnClosed(CInstantCamera &camera){
     {
         std::lock_guard<std::mutex> lock(_connectionStateMutex);
         _connectedCameraName.clear();
+        _infoMetric.reset();
     }
     auto from = "[Info " + to_string(_allottedNumber)  +"] " + cameraName;
     CameraSystem::syslog(from + " closed.");
-    dispatchCallbacks(_statusMutex, _statusObservers, ConnectionStatus, false);
+    _statusObservers.dispatch(ConnectionStatus, false);
 }
 
 void Camera::OnCameraDeviceRemoved(CInstantCamera &camera){
@@ -776,23 +2063,24 @@ void Camera::OnCameraDeviceRemoved(CInstantCamera &camera){
     {
         std::lock_guard<std::mutex> lock(_connectionStateMutex);
         _connectedCameraName.clear();
+        _infoMetric.reset();
     }
     auto from = "[Info " + to_string(_allottedNumber)  +"] " + cameraName;
     CameraSystem::syslog(from + " removed physically.");
-    dispatchCallbacks(_statusMutex, _statusObservers, GrabbingStatus, false);
-    dispatchCallbacks(_statusMutex, _statusObservers, ConnectionStatus, false);
+    _statusObservers.dispatch(GrabbingStatus, false);
+    _statusObservers.dispatch(ConnectionStatus, false);
 }
 
 void Camera::OnGrabStarted(CInstantCamera &camera){
     auto from = "[Info " + to_string(_allottedNumber)  +"] " + safeCameraName(camera, getConnectedCameraName());
     CameraSystem::syslog(from + " started grabbing.");
-    dispatchCallbacks(_statusMutex, _statusObservers, GrabbingStatus, true);
+    _statusObservers.dispatch(GrabbingStatus, true);
 }
 
 void Camera::OnGrabStopped(CInstantCamera &camera){
     auto from = "[Info " + to_string(_allottedNumber)  +"] " + safeCameraName(camera, getConnectedCameraName());
     CameraSystem::syslog(from + " stopped grabbing.");
-    dispatchCallbacks(_statusMutex, _statusObservers, GrabbingStatus, false);
+    _statusObservers.dispatch(GrabbingStatus, false);
 }
 
 void Camera::OnCameraEvent(CInstantCamera &camera, intptr_t userProvidedId, GenApi::INode *pNode){
@@ -810,8 +2098,9 @@ void Camera::OnCameraEvent(CInstantCamera &camera, intptr_t userProvidedId, GenA
         return;
     }
 
+    _parameterCache.refresh(pNode);
     if(!nodeName.empty()){
-        dispatchCallbacks(_nodeCallbackMutex, _nodeCallbacks, nodeName);
+        _nodeCallbacks.dispatch(nodeName);
     }
 }
 
@@ -821,13 +2110,17 @@ void Camera::markOpened(CInstantCamera& camera)
     {
         std::lock_guard<std::mutex> lock(_connectionStateMutex);
         _connectedCameraName = cameraName;
+        _infoMetric = MetricsRegistry::instance().gauge("camera_info",
+            "Device connected to each camera slot; the value is always 1.",
+            {{"camera", std::to_string(_allottedNumber)}, {"name", cameraName}});
+        _infoMetric->set(1);
     }
     const bool wasAvailable = _deviceAvailable.exchange(true, std::memory_order_acq_rel);
     if(wasAvailable) return;
 
     auto from = "[Info " + to_string(_allottedNumber)  +"] " + cameraName;
     CameraSystem::syslog(from + " opened.");
-    dispatchCallbacks(_statusMutex, _statusObservers, ConnectionStatus, true);
+    _statusObservers.dispatch(ConnectionStatus, true);
 }
 
 void Camera::registerNodeEventHandlers()
@@ -865,6 +2158,24 @@ void Camera::registerNodeEventHandlers()
             }
         }
     }
+
+    // Cached parameters need notifications even where the feature tree nests them deeper.
+    for(std::size_t index = 0; index < CachedParameterCount; ++index){
+        auto nodeName = _parameterCache.featureName(static_cast<CachedParameter>(index));
+        if(nodeName.empty()) continue;
+        if(std::find(_registeredNodeEventNames.begin(), _registeredNodeEventNames.end(), nodeName) != _registeredNodeEventNames.end()) continue;
+        try{
+            _currentCamera.RegisterCameraEventHandler(this,
+                                                     nodeName.c_str(),
+                                                     _allottedNumber,
+                                                     ERegistrationMode::RegistrationMode_Append,
+                                                     ECleanup::Cleanup_None,
+                                                     CameraEventAvailability_Optional);
+            _registeredNodeEventNames.push_back(std::move(nodeName));
+        }catch(const GenericException &e){
+            CameraSystem::syslog(e.GetDescription(), true);
+        }
+    }
 }
 
 void Camera::clearNodeEventHandlers()
@@ -875,3 +2186,13 @@ void Camera::clearNodeEventHandlers()
     _registeredNodeEventNames.clear();
 }
 
+void Camera::refreshCachedParameters(const std::vector<GenApi::INode*>& applied)
+{
+    for(auto* node : applied){
+        // Other features (binning, user sets, commands) can move cached values too.
+        if(!_parameterCache.refresh(node)){
+            _parameterCache.refreshAll();
+            return;
+        }
+    }
+}
@@ -11,22 +11,39 @@
 
 #include <pylon/PylonIncludes.h>
 #include <pylon/BaslerUniversalInstantCamera.h>
+#include "CallbackRegistry.h"
+#include "ConfigurationSnapshot.h"
+#include "DeviceProfileCache.h"
+#include "FrameArena.h"
+#include "FrameDelivery.h"
+#include "FrameHandle.h"
+#include "LatencyHistogram.h"
+#include "MetricsRegistry.h"
+#include "ParameterCache.h"
+#include "ParameterWriter.h"
 #include "PylonScene3DProfile.h"
+#include "SpscRing.h"
+#include "ThreadSettings.h"
 #include <thread>
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <mutex>
 #include <condition_variable>
+#include <memory>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
 using namespace Pylon;
 using namespace std;
 
+class AcquisitionReactor;
 class CameraSystem;
 class Camera : public Pylon::CConfigurationEventHandler,
                public Pylon::CCameraEventHandler
 {
+    friend class AcquisitionReactor;
     friend class CameraSystem;
 
 public:
@@ -57,10 +74,25 @@ public:
      */
     void clearStatusCallbacks();
 
+    /** Duration of each phase of the last `open()`; a failed open names the phase that threw. */
+    struct OpenTiming
+    {
+        std::chrono::microseconds createDevice{0};
+        std::chrono::microseconds open{0};
+        /** Device-class detection and stream configuration. */
+        std::chrono::microseconds configure{0};
+        std::chrono::microseconds eventHandlers{0};
+        std::chrono::microseconds total{0};
+        /** Empty on success, otherwise `createDevice`, `open`, `configure`, or `eventHandlers`. */
+        std::string failedPhase;
+        std::string error;
+    };
+
     bool open(const std::string& cameraName="");
     bool isOpened() const;
     void close();
     std::string getConnectedCameraName() const;
+    [[nodiscard]] OpenTiming lastOpenTiming() const;
 
     using GrabCallback = std::function<void(const CPylonImage&, size_t frame)>;
     /**
@@ -69,6 +101,15 @@ public:
      * @return Callback identifier that can be passed to `deregisterGrabCallback()`.
      */
     CallbackId registerGrabCallback(GrabCallback cb);
+    /**
+     * @brief Registers a 2D grab callback that runs on its own executor thread.
+     * @param cb Callback invoked from a bounded per-subscriber queue.
+     * @param delivery Queue depth and the policy applied when the queue is full.
+     * @return Callback identifier that can be passed to `deregisterGrabCallback()`.
+     */
+    CallbackId registerGrabCallback(GrabCallback cb, const FrameDeliveryOptions& delivery);
+    /** Queue statistics of an asynchronous 2D subscriber, or empty for synchronous or unknown IDs. */
+    [[nodiscard]] std::optional<FrameDeliveryStatistics> grabDeliveryStatistics(CallbackId id) const;
     /**
      * @brief Removes a previously registered 2D grab callback.
      * @param id Callback identifier returned by `registerGrabCallback()`.
@@ -87,6 +128,15 @@ public:
      * @return Callback identifier that can be passed to `deregisterGrab3DCallback()`.
      */
     CallbackId registerGrab3DCallback(Grab3DCallback cb);
+    /**
+     * @brief Registers a 3D grab callback that runs on its own executor thread.
+     * @param cb Callback invoked from a bounded per-subscriber queue.
+     * @param delivery Queue depth and the policy applied when the queue is full.
+     * @return Callback identifier that can be passed to `deregisterGrab3DCallback()`.
+     */
+    CallbackId registerGrab3DCallback(Grab3DCallback cb, const FrameDeliveryOptions& delivery);
+    /** Queue statistics of an asynchronous 3D subscriber, or empty for synchronous or unknown IDs. */
+    [[nodiscard]] std::optional<FrameDeliveryStatistics> grab3DDeliveryStatistics(CallbackId id) const;
     /**
      * @brief Removes a previously registered 3D grab callback.
      * @param id Callback identifier returned by `registerGrab3DCallback()`.
@@ -97,8 +147,182 @@ public:
      * @brief Removes every registered 3D grab callback.
      */
     void clearGrab3DCallbacks();
-    /** Returns one consumer credit when free-run backpressure is active. */
+
+    using FrameCallback = std::function<void(const FrameHandle& frame)>;
+    /**
+     * @brief Registers a callback for retainable 2D and multipart grab results.
+     * @param cb Callback invoked for every successfully grabbed frame. Copies of the
+     *        handle may be kept past the callback; each retained frame holds one
+     *        stream buffer until it is released.
+     * @return Callback identifier that can be passed to `deregisterFrameCallback()`.
+     */
+    CallbackId registerFrameCallback(FrameCallback cb);
+    /**
+     * @brief Registers a frame callback that runs on its own executor thread.
+     * @param cb Callback invoked from a bounded per-subscriber queue.
+     * @param delivery Queue depth and the policy applied when the queue is full.
+     * @return Callback identifier that can be passed to `deregisterFrameCallback()`.
+     */
+    CallbackId registerFrameCallback(FrameCallback cb, const FrameDeliveryOptions& delivery);
+    /** Queue statistics of an asynchronous frame subscriber, or empty for synchronous or unknown IDs. */
+    [[nodiscard]] std::optional<FrameDeliveryStatistics> frameDeliveryStatistics(CallbackId id) const;
+    /**
+     * @brief Removes a previously registered frame callback.
+     * @param id Callback identifier returned by `registerFrameCallback()`.
+     * @return `true` if the callback existed and was removed.
+     */
+    bool deregisterFrameCallback(CallbackId id);
+    /**
+     * @brief Removes every registered frame callback.
+     */
+    void clearFrameCallbacks();
+    /**
+     * @brief Returns the credit of the oldest outstanding frame when free-run backpressure is active.
+     * @note Subscribers that share a camera should prefer `ready(frame)`, which is idempotent per frame.
+     */
     void ready();
+    /**
+     * @brief Returns the credit held by one delivered frame.
+     * @param frame Sequence number passed to the grab callback or held by the FrameHandle.
+     * @note Unknown or already returned sequence numbers are ignored and counted as stale.
+     */
+    void ready(size_t frame);
+    /**
+     * @brief Sets how many free-run frames may be outstanding before the worker waits for `ready()`.
+     * @param window Credit window, at least one. Applied by the next `grab()`.
+     */
+    void setCreditWindow(size_t window);
+    [[nodiscard]] size_t creditWindow() const;
+
+    struct CreditStatistics
+    {
+        size_t window = 0;
+        size_t outstanding = 0;
+        /** Frames whose delivery had to wait for a credit. */
+        uint64_t waits = 0;
+        uint64_t blockedNanoseconds = 0;
+        uint64_t maxBlockedNanoseconds = 0;
+        /** `ready(frame)` calls for frames that held no credit. */
+        uint64_t staleReturns = 0;
+    };
+    /** Credit window state and time the worker spent blocked waiting for credits in the current or last grab. */
+    [[nodiscard]] CreditStatistics creditStatistics() const;
+
+    /** Stream buffer and grab strategy settings applied when `grab()` arms acquisition. */
+    struct GrabOptions
+    {
+        enum class Strategy
+        {
+            /** OneByOne in trigger mode, LatestImageOnly in free-run. */
+            Auto,
+            OneByOne,
+            LatestImageOnly,
+            /** Keeps the newest `outputQueueSize` frames and discards older ones. */
+            LatestImages,
+            /** Queues a buffer only when a result is requested; removes stale frames. */
+            UpcomingImage
+        };
+
+        Strategy strategy = Strategy::Auto;
+        /** Stream buffer count; zero keeps the trigger-dependent default of 30 or 5. */
+        size_t bufferCount = 0;
+        /** Output queue size used by `Strategy::LatestImages`; clamped to the buffer count. */
+        size_t outputQueueSize = 1;
+        /** Re-sizes the buffer pool between grabs from observed loss and buffer usage. */
+        bool autoTuneBuffers = false;
+        size_t minBufferCount = 2;
+        size_t maxBufferCount = 64;
+        /** Upper bound for buffer count times payload size in bytes; zero disables the cap. */
+        size_t bufferMemoryCap = 0;
+    };
+    /**
+     * @brief Replaces the options used by the next `grab()` call.
+     * @note A grab that is already running keeps the options it was armed with.
+     */
+    void setGrabOptions(const GrabOptions& options);
+    [[nodiscard]] GrabOptions grabOptions() const;
+    /** Buffer count chosen by the auto-tuner for the next grab, or zero before the first tuned run. */
+    [[nodiscard]] size_t tunedBufferCount() const;
+
+    /**
+     * @brief Requests per-frame chunk metadata (exposure, gain, frame counter, timestamp, line status).
+     *
+     * Applied by the next `grab()` or `captureBurst()` before acquisition
+     * starts, and on every later open. Values arrive through
+     * `FrameHandle::chunkMetadata()` for 2D streams.
+     */
+    void setChunkMetadataEnabled(bool enabled);
+    [[nodiscard]] bool isChunkMetadataEnabled() const;
+    /** `true` when the connected camera accepted chunk mode. */
+    [[nodiscard]] bool isChunkMetadataActive() const;
+
+    /**
+     * @brief Cumulative frame accounting since construction or `resetStatistics()`.
+     *
+     * `blockIdGaps` counts every frame missing from the block-ID sequence,
+     * whether lost on the transport or skipped on the host, so transport loss is
+     * roughly `blockIdGaps - skippedImages`. Stream-grabber counters are sampled
+     * about once per second while grabbing and once when the grab ends.
+     */
+    struct Statistics
+    {
+        /** Grab results retrieved, successful or not. */
+        uint64_t received = 0;
+        /** Frames handed to callbacks and the pull ring. */
+        uint64_t delivered = 0;
+        /** Images the grab strategy discarded before retrieval, e.g. with LatestImageOnly. */
+        uint64_t skippedImages = 0;
+        uint64_t blockIdGaps = 0;
+        /** Results with `GrabSucceeded() == false`, including incomplete buffers. */
+        uint64_t failedBuffers = 0;
+        /** Stream grabber `Statistic_Buffer_Underrun_Count` increments: no free buffer was queued. */
+        uint64_t bufferUnderruns = 0;
+        /** Stream grabber `Statistic_Missed_Frame_Count` increments. */
+        uint64_t missedFrames = 0;
+        /** Free-run frames that waited for a consumer credit, and the total wait. */
+        uint64_t creditStalls = 0;
+        uint64_t creditStallNanoseconds = 0;
+    };
+    /** Lock-free snapshot; individual counters are read independently. */
+    [[nodiscard]] Statistics statistics() const;
+    void resetStatistics();
+
+    /**
+     * @brief End-to-end host latency of every delivered frame, in nanoseconds.
+     *
+     * Measured from `RetrieveResult` returning the frame to the last synchronous
+     * callback returning, including any credit wait. Accumulates across grabs
+     * until `resetLatencyHistogram()`; query it with `percentile(99.9)` and similar.
+     */
+    [[nodiscard]] const LatencyHistogram& latencyHistogram() const;
+    void resetLatencyHistogram();
+
+    /** Scheduling settings for the frame-receive worker and pylon's internal grab engine thread. */
+    struct AcquisitionThreadOptions
+    {
+        /** Worker thread settings; the default name is `cam<N>-grab`. */
+        ThreadSettings worker;
+        /** Applied to the delivery queue executors; the default name is `cam<N>-deliver`. */
+        ThreadSettings delivery;
+        /** Passes `grabEngineThreadPriority` to pylon's `InternalGrabEngineThreadPriority`. */
+        bool overrideGrabEngineThreadPriority = false;
+        int grabEngineThreadPriority = 0;
+    };
+    /** Outcome of applying `AcquisitionThreadOptions` in the current or last grab. */
+    struct AcquisitionThreadDiagnostics
+    {
+        ThreadSettingsReport worker;
+        bool grabEnginePriorityApplied = false;
+        int64_t grabEngineThreadPriority = 0;
+        std::string grabEngineError;
+    };
+    /**
+     * @brief Replaces the thread settings used by the next `grab()` and by queues registered afterwards.
+     * @note Real-time policies usually need elevated privileges; failures are reported in diagnostics.
+     */
+    void setAcquisitionThreadOptions(const AcquisitionThreadOptions& options);
+    [[nodiscard]] AcquisitionThreadOptions acquisitionThreadOptions() const;
+    [[nodiscard]] AcquisitionThreadDiagnostics acquisitionThreadDiagnostics() const;
 
     /**
      * Arms pylon acquisition and starts the frame-receive worker.
@@ -106,10 +330,96 @@ public:
      * @note Frame retrieval and callbacks run on the owned worker thread.
      */
     void grab(size_t frames=0);
+    /**
+     * @brief Enables pull delivery through a lock-free single-consumer frame ring.
+     * @param capacity Frames retained until popped, rounded up to a power of two.
+     * @return `false` while grabbing; the ring can only be replaced between grabs.
+     *         A consumer blocked in `waitForFrame()` returns an invalid handle first.
+     * @note Retained frames hold stream buffers, so keep the capacity below the
+     *       buffer count. When the ring is full the newest frame is dropped.
+     */
+    bool enablePullMode(size_t capacity);
+    /** Stops filling the pull ring; frames already queued can still be popped. */
+    void disablePullMode();
+    [[nodiscard]] bool isPullModeEnabled() const;
+    /**
+     * @brief Waits for the next pulled frame.
+     * @return The frame, or an invalid handle on timeout or when acquisition stops.
+     * @note Pull-mode calls must come from one consumer thread at a time.
+     */
+    FrameHandle waitForFrame(std::chrono::milliseconds timeout);
+    /** Pops the next pulled frame without waiting. */
+    bool tryPopFrame(FrameHandle& frame);
+
+    struct PullStatistics
+    {
+        size_t capacity = 0;
+        size_t depth = 0;
+        uint64_t pushed = 0;
+        uint64_t popped = 0;
+        /** Frames dropped because the ring was full. */
+        uint64_t overflows = 0;
+    };
+    [[nodiscard]] PullStatistics pullStatistics() const;
+
+    /**
+     * @brief Captures a burst of 2D frames into one preallocated contiguous arena.
+     * @param frames Number of frames to capture.
+     * @param arena Destination; grown before acquisition starts when too small.
+     * @param frameTimeout Longest wait for any single frame before the burst ends early.
+     * @return Number of frames stored in `arena`.
+     * @note Runs on the calling thread while no grab is active and does not invoke
+     *       grab callbacks. `requestStop()` ends the burst early.
+     */
+    size_t captureBurst(size_t frames,
+                        FrameArena& arena,
+                        std::chrono::milliseconds frameTimeout = std::chrono::milliseconds(5000));
+
     /** Requests stop and joins the frame-receive worker. */
     void stop();
     /** Requests worker stop without joining the caller. */
     void requestStop();
+    /**
+     * @brief Executes one software frame trigger.
+     * @param readyTimeout Time to wait for the camera to become trigger-ready; zero triggers immediately.
+     * @return `false` when the camera was not ready or the trigger failed.
+     */
+    bool executeSoftwareTrigger(std::chrono::milliseconds readyTimeout = std::chrono::milliseconds(0));
+
+    /** Reads every streamable feature, including each selector combination; empty when closed. */
+    [[nodiscard]] ConfigurationSnapshot captureConfiguration();
+    /**
+     * @brief Writes only the features whose current value differs from `snapshot`.
+     *
+     * Values are compared first; when something differs and the camera is
+     * grabbing, acquisition is stopped once for all writes and restarted; a
+     * finite grab restarts with the frames it had not delivered yet. Features locked during acquisition are compared
+     * by reading them and written after the stop; entries that cannot be read
+     * are listed in `notComparableFeatures`.
+     */
+    ConfigurationApplyReport applyConfiguration(const ConfigurationSnapshot& snapshot);
+
+    /**
+     * @brief Queues feature writes on the camera's `cam<N>-param` thread.
+     *
+     * Repeated writes to one feature, such as slider updates, collapse to the
+     * last value; results arrive through futures or writer-thread callbacks.
+     * `close()` waits for a pass in progress, and later writes fail until the
+     * camera is open again.
+     */
+    ParameterWriter& parameterWriter() noexcept { return _parameterWriter; }
+
+    /**
+     * @brief Shadow copies of exposure, gain, ROI, and frame rate.
+     *
+     * Safe to call from any thread at frame rate: the values are refreshed by
+     * node notifications and by the camera's own writes, and reading them
+     * makes no GenApi calls.
+     */
+    [[nodiscard]] ParameterSnapshot cachedParameters() const { return _parameterCache.snapshot(); }
+    [[nodiscard]] std::optional<double> cachedParameter(CachedParameter parameter) const { return _parameterCache.value(parameter); }
+    /** Queues a write through the handle resolved at open; the shadow copy follows once it reaches the device. */
+    std::future<ParameterWriteResult> writeCachedParameter(CachedParameter parameter, double value);
 
     std::vector<std::string> getUpdatedCameraList() const;
     std::vector<std::string> getCachedCameraList() const;
@@ -141,35 +451,155 @@ private:
         MultiPart3D
     };
 
+    struct StreamCounters
+    {
+        int64_t bufferUnderruns = 0;
+        int64_t missedFrames = 0;
+    };
+
+    struct LossCounters
+    {
+        std::atomic<uint64_t> received{0};
+        std::atomic<uint64_t> delivered{0};
+        std::atomic<uint64_t> skippedImages{0};
+        std::atomic<uint64_t> blockIdGaps{0};
+        std::atomic<uint64_t> failedBuffers{0};
+        std::atomic<uint64_t> bufferUnderruns{0};
+        std::atomic<uint64_t> missedFrames{0};
+        std::atomic<uint64_t> creditStalls{0};
+        std::atomic<uint64_t> creditStallNanoseconds{0};
+    };
+
+    // Per-grab receive state shared by the owned worker thread and the reactor.
+    struct GrabSession
+    {
+        bool triggerMode = false;
+        GrabOptions options;
+        size_t bufferCount = 0;
+        GenApi::IInteger* readyBuffersNode = nullptr;
+        StreamCounters streamBaseline;
+        StreamCounters streamSample;
+        std::optional<uint64_t> previousBlockId;
+        bool parseChunks = false;
+        ChunkMetadataParser chunkParser;
+        std::chrono::steady_clock::time_point started;
+        std::chrono::steady_clock::time_point nextProgressLog;
+        std::chrono::steady_clock::time_point nextStreamSample;
+        std::chrono::milliseconds maximumCallbackTime{0};
+        size_t slowCallbackCount = 0;
+        size_t delivered = 0;
+        int64_t peakReadyBuffers = 0;
+        std::chrono::steady_clock::time_point rateSampledAt;
+        size_t rateDelivered = 0;
+        // Result retrieved on the reactor while no credit was free; delivered before the next one.
+        Pylon::CGrabResultPtr parkedResult;
+        size_t parkedSeq = 0;
+        int64_t parkedReceiveNs = 0;
+    };
+
+    // Series in MetricsRegistry::instance() labelled camera="<allotted number>"; never null.
+    struct Metrics
+    {
+        std::shared_ptr<MetricCounter> framesDelivered;
+        std::shared_ptr<MetricCounter> framesFailed;
+        std::shared_ptr<MetricCounter> framesDropped;
+        std::shared_ptr<MetricGauge> frameRate;
+        std::shared_ptr<MetricGauge> pullQueueDepth;
+        std::shared_ptr<MetricGauge> creditsOutstanding;
+        std::shared_ptr<MetricGauge> bufferPoolSize;
+        std::shared_ptr<MetricGauge> bufferPoolReady;
+        std::shared_ptr<MetricGauge> bufferPoolQueued;
+        std::shared_ptr<MetricHistogram> creditWait;
+        std::shared_ptr<MetricHistogram> callbackLatency;
+    };
+
+    enum class DrainResult
+    {
+        Rearm,
+        /** A result waits for a credit; `ready()` wakes the camera again. */
+        Parked,
+        Finished
+    };
+
+    enum class GrabWait
+    {
+        Result,
+        Timeout,
+        Stopped
+    };
+
     CameraSystem *_system;
     mutable std::mutex _connectionStateMutex;
     std::string _connectedCameraName;
+    // camera_info series naming the connected device; null while closed.
+    std::shared_ptr<MetricGauge> _infoMetric;
+    OpenTiming _openTiming;
     int _allottedNumber = 0;
 
     std::thread _thread;
+    std::unique_ptr<GrabSession> _session;
+    // Reactor driving the current grab, or null when it runs on _thread.
+    std::mutex _sessionMutex;
+    std::condition_variable _sessionCondition;
+    AcquisitionReactor* _sessionReactor = nullptr;
     std::atomic<bool> _isRunning=false;
+    // Signalled by requestStop() so a worker blocked on the stream wakes at once.
+    Pylon::WaitObjectEx _stopEvent;
     std::atomic<bool> _deviceAvailable=false;
+    // Declared before the writer, whose hooks refresh it.
+    ParameterCache _parameterCache;
+    ParameterWriter _parameterWriter;
 
-    std::mutex _statusMutex;
-    std::unordered_map<size_t, StatusCallback> _statusObservers;
-    std::atomic<size_t> _nextStatusObserverId{1};
-
-    std::mutex _grabCallbackMutex;
-    std::unordered_map<size_t, GrabCallback> _grabCallbacks;
-    std::atomic<size_t> _nextGrabCallbackId{1};
-
-    std::mutex _grab3DCallbackMutex;
-    std::unordered_map<size_t, Grab3DCallback> _grab3DCallbacks;
-    std::atomic<size_t> _nextGrab3DCallbackId{1};
+    CallbackRegistry<StatusCallback> _statusObservers;
+    // 2D and 3D callbacks are stored as frame callbacks so synchronous and queued
+    // subscribers share one identifier space per callback kind.
+    CallbackRegistry<FrameCallback> _grabCallbacks;
+    CallbackRegistry<FrameCallback> _grab3DCallbacks;
+    CallbackRegistry<FrameCallback> _frameCallbacks;
 
-    std::mutex _nodeCallbackMutex;
-    std::unordered_map<size_t, NodeCallback> _nodeCallbacks;
-    std::atomic<size_t> _nextNodeCallbackId{1};
+    using DeliveryQueues = std::unordered_map<CallbackId, std::shared_ptr<FrameDeliveryQueue>>;
+    mutable std::mutex _deliveryQueueMutex;
+    DeliveryQueues _grabDeliveryQueues;
+    DeliveryQueues _grab3DDeliveryQueues;
+    DeliveryQueues _frameDeliveryQueues;
+    CallbackRegistry<NodeCallback> _nodeCallbacks;
 
-    std::mutex _permitMutex;
+    mutable std::mutex _permitMutex;
     std::condition_variable _permitCondition;
-    std::atomic<int> _permits{0};
+    std::atomic<size_t> _creditWindow{1};
+    // Sequence numbers holding a credit, oldest first; guarded by _permitMutex.
+    std::vector<size_t> _outstandingCredits;
+    CreditStatistics _creditStatistics;
+    // Set when a reactor strand parked for a credit; guarded by _permitMutex.
+    bool _creditParked = false;
     std::atomic<bool> _permitBackpressureEnabled{false};
+    std::atomic<bool> _reactorFallbackLogged{false};
+
+    mutable std::mutex _grabOptionsMutex;
+    GrabOptions _grabOptions;
+    std::atomic<size_t> _tunedBufferCount{0};
+    LatencyHistogram _latencyHistogram;
+    Metrics _metrics;
+    LossCounters _lossCounters;
+    std::atomic<bool> _chunkMetadataEnabled{false};
+    std::atomic<bool> _chunkMetadataActive{false};
+    // Set by setChunkMetadataEnabled(); the next grab() or captureBurst() applies the change.
+    std::atomic<bool> _chunkMetadataPending{false};
+    AcquisitionThreadOptions _threadOptions;
+    AcquisitionThreadDiagnostics _threadDiagnostics;
+
+    std::unique_ptr<SpscRing<FrameHandle>> _pullRing;
+    std::atomic<bool> _pullEnabled{false};
+    std::atomic<bool> _pullConsumerWaiting{false};
+    std::atomic<uint64_t> _pullInterrupts{0};
+    std::atomic<uint64_t> _pullPushed{0};
+    std::atomic<uint64_t> _pullPopped{0};
+    std::atomic<uint64_t> _pullOverflows{0};
+    std::mutex _pullMutex;
+    std::condition_variable _pullCondition;
+    // Consumers inside the pull API; enablePullMode() waits for them to leave before replacing _pullRing.
+    mutable std::atomic<int> _pullConsumers{0};
+    std::atomic<bool> _pullReplacing{false};
 
     std::atomic<size_t> _frameSeq{0};
     std::atomic<size_t> _frameTarget{0};
@@ -181,12 +611,82 @@ private:
     CBaslerUniversalInstantCamera _currentCamera;
 
     void configureStreamForConnectedCamera();
-    void configureBlazeStream(GenApi::INodeMap& nodeMap);
-    void configureStereoAceStream(GenApi::INodeMap& nodeMap);
-    void configureStereoMiniStream(GenApi::INodeMap& nodeMap);
+    // `cached` narrows pixel-format fallbacks and replaces the calibration reads; `layout` receives the enabled components.
+    // A stereo cache hit still costs four register reads to confirm the calibration (runtimeCalibrationMatches()).
+    // Return `false` when there was no cached profile or the camera no longer matches it.
+    bool configureBlazeStream(GenApi::INodeMap& nodeMap, const DeviceProfile* cached,
+                              std::vector<DeviceProfile::Component>& layout);
+    bool configureStereoAceStream(GenApi::INodeMap& nodeMap, const DeviceProfile* cached,
+                                  std::vector<DeviceProfile::Component>& layout);
+    bool configureStereoMiniStream(GenApi::INodeMap& nodeMap, const DeviceProfile* cached,
+                                   std::vector<DeviceProfile::Component>& layout);
+    void applyChunkMetadataMode();
+    void applyPendingChunkMetadataMode();
     void markOpened(Pylon::CInstantCamera& camera);
+    /** Updates the loss counters for one retrieved result. */
+    void countGrabResult(const Pylon::CGrabResultPtr& result, std::optional<uint64_t>& previousBlockId);
+    static StreamCounters readStreamCounters(GenApi::INodeMap& streamNodeMap);
+    /** Adds stream-grabber counter increments since `last` and updates it. */
+    void sampleStreamCounters(StreamCounters& last);
+    /** Counts, times, and delivers one retrieved result; `false` ends the grab. */
+    bool processGrabResult(GrabSession& session, const Pylon::CGrabResultPtr& grabResult);
+    /** Delivers a result that already holds its credit; `false` ends the grab. */
+    bool deliverGrabResult(GrabSession& session, const Pylon::CGrabResultPtr& grabResult,
+                           size_t seq, int64_t hostReceiveNs);
+    /** Retries the credit of the parked result and delivers it once one is free. */
+    DrainResult resumeParkedResult(GrabSession& session);
+    void sampleStreamCountersIfDue(GrabSession& session);
+    /** Updates the frame-rate and buffer-pool gauges from the interval since the last sample. */
+    void sampleRateMetrics(GrabSession& session, std::chrono::steady_clock::time_point now);
+    static Metrics registerMetrics(int allottedNumber);
+    /** Stops grabbing, applies buffer auto-tuning, and logs the worker summary. */
+    void finishGrab(GrabSession& session);
+    /** Reactor entry point: processes up to `budget` queued results in order. */
+    DrainResult drainGrabResults(size_t budget);
+    bool isSessionLive() const;
+    const Pylon::WaitObject& grabResultWaitObject();
+    /** Called by the reactor once a drained session finished; the reactor no longer touches this camera. */
+    void finishReactorSession();
+    void waitForReactorSession();
+    /** Grab result, stop event, and grab-stop wait objects, in that order. */
+    Pylon::WaitObjects makeGrabWaitObjects();
+    static GrabWait waitForGrabResult(const Pylon::WaitObjects& waitObjects, unsigned int timeoutMs);
+    /** Non-blocking `RetrieveResult`; call after `waitForGrabResult()` reported a result. */
+    bool retrieveGrabResult(Pylon::CGrabResultPtr& grabResult);
+    /** Hands one frame to the pull ring and every registered callback. */
+    void deliverFrame(const FrameHandle& frame);
+    void pushPullFrame(const FrameHandle& frame);
+    void interruptPullWaiters();
+    /** Counts the caller in as a pull consumer; `false` while the ring is being replaced. */
+    bool enterPullConsumer() const;
+    bool popPullFrame(FrameHandle& frame);
+    struct PullConsumerScope
+    {
+        std::atomic<int>& consumers;
+        ~PullConsumerScope() { consumers.fetch_sub(1, std::memory_order_release); }
+    };
+    /** Blocks until `frame` holds a credit; returns `false` when acquisition stops first. */
+    bool acquireCredit(size_t frame);
+    /**
+     * Non-blocking `acquireCredit()` for reactor strands. Without a free credit it
+     * returns `false` and the next returned credit wakes the camera's strand.
+     */
+    bool tryAcquireCredit(size_t frame);
+    void recordCreditWait(uint64_t blockedNanoseconds);
+    void wakeReactorSession();
+    CallbackId registerQueuedCallback(CallbackRegistry<FrameCallback>& registry,
+                                      DeliveryQueues& queues,
+                                      FrameCallback handler,
+                                      const FrameDeliveryOptions& delivery);
+    void stopDeliveryQueue(DeliveryQueues& queues, CallbackId id);
+    void stopDeliveryQueues(DeliveryQueues& queues);
+    std::optional<FrameDeliveryStatistics> deliveryStatistics(const DeliveryQueues& queues, CallbackId id) const;
+    /** `true` when any subscriber queue uses `Policy::Block`. */
+    bool hasBlockingDeliveryQueue() const;
     void registerNodeEventHandlers();
     void clearNodeEventHandlers();
+    /** Writer hook: refreshes written cached parameters, or all of them after any other write. */
+    void refreshCachedParameters(const std::vector<GenApi::INode*>& applied);
 
 
 protected:
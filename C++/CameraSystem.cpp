@@ -1,14 +1,22 @@
 #include "CameraSystem.h"
+#include "ThreadSettings.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <stdexcept>
+#include <thread>
+#include <utility>
 
 CameraSystem::CameraSystem(){
+    // Constructing the logger first makes it outlive this system, whose destructor still logs.
+    Logger::instance();
     PylonInitialize();
     _tlFactory = &CTlFactory::GetInstance();
 }
 
 CameraSystem::~CameraSystem(){
+    disableDiscovery();
     while(true){
         Camera* camera = nullptr;
         {
@@ -19,7 +27,14 @@ CameraSystem::~CameraSystem(){
         }
         delete camera;
     }
+    disableAcquisitionReactor();
     try{
+        for(auto& loaded : _transportLayers){
+            if(loaded.transportLayer){
+                _tlFactory->ReleaseTl(loaded.transportLayer);
+                loaded.transportLayer = nullptr;
+            }
+        }
         PylonTerminate();
     }catch(const GenericException &e){
         syslog(e.GetDescription(), true);
@@ -28,22 +43,79 @@ CameraSystem::~CameraSystem(){
     }catch(...){
         syslog("Unknown exception while terminating pylon", true);
     }
+    Logger::instance().flush();
 }
 
-void CameraSystem::updateCameraListLocked()
+std::shared_ptr<const DeviceTable> CameraSystem::refreshDeviceTable(const bool onlyIfStale, const bool background)
 {
-    _devices.clear();
-    auto cnt = _tlFactory->EnumerateDevices(_devices);
-    syslog("Updated the camera list: " + to_string(cnt) + " Camera(s) found.");
-    for(auto i=0; i<_devices.size(); ++i){
-        syslog("-- " + std::string(_devices.at(i).GetFriendlyName()));
+    std::unique_lock<std::mutex> enumerationLock(_enumerationMutex);
+    if(onlyIfStale){
+        std::lock_guard<std::mutex> lock(_mutex);
+        const bool expired = _deviceTableTtl.count() > 0 && _deviceTable->age() >= _deviceTableTtl;
+        if(_deviceTable->isEnumerated() && !expired) return nullptr;
+    }
+
+    DeviceInfoList_t devices;
+    const auto cnt = enumerateDevices(devices);
+    auto table = std::make_shared<const DeviceTable>(std::move(devices), DeviceTable::Clock::now());
+    std::shared_ptr<const DeviceTable> previous;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        previous = std::exchange(_deviceTable, table);
+    }
+    const auto diff = diffDeviceTables(*previous, table);
+
+    if(!background){
+        syslog("Updated the camera list: " + to_string(cnt) + " Camera(s) found.");
+        for(const auto& device : table->devices()){
+            syslog("-- " + std::string(device.GetFriendlyName()));
+        }
+    }else{
+        for(const auto& device : diff.added){
+            syslog("Camera added: " + std::string(device.GetFriendlyName()));
+        }
+        for(const auto& device : diff.removed){
+            syslog("Camera removed: " + std::string(device.GetFriendlyName()));
+        }
+        for(const auto& device : diff.changed){
+            syslog("Camera changed: " + std::string(device.GetFriendlyName()));
+        }
+    }
+    if(!diff.empty()){
+        std::lock_guard<std::mutex> lock(_deviceListDispatchMutex);
+        _pendingDeviceListDiffs.push_back(std::move(diff));
     }
+    // Queued under the enumeration lock, so diffs keep the enumeration order
+    // while the callbacks run without it and may enumerate again.
+    enumerationLock.unlock();
+    dispatchDeviceListDiffs();
+    return table;
+}
+
+void CameraSystem::dispatchDeviceListDiffs()
+{
+    std::unique_lock<std::mutex> lock(_deviceListDispatchMutex);
+    if(_dispatchingDeviceList) return;
+    _dispatchingDeviceList = true;
+    try{
+        while(!_pendingDeviceListDiffs.empty()){
+            const auto diff = std::move(_pendingDeviceListDiffs.front());
+            _pendingDeviceListDiffs.pop_front();
+            lock.unlock();
+            _deviceListCallbacks.dispatch(diff);
+            lock.lock();
+        }
+    }catch(...){
+        if(!lock.owns_lock()) lock.lock();
+        _dispatchingDeviceList = false;
+        throw;
+    }
+    _dispatchingDeviceList = false;
 }
 
 void CameraSystem::updateCameraList(){
     try{
-        std::lock_guard<std::mutex> lock(_mutex);
-        updateCameraListLocked();
+        refreshDeviceTable();
     }catch(const GenericException &e){
         syslog(e.what(), true);
     }catch(const std::exception &e){
@@ -54,12 +126,8 @@ void CameraSystem::updateCameraList(){
 }
 
 std::vector<string> CameraSystem::getCameraList() {
-    std::vector<std::string> list;
     try{
-        std::lock_guard<std::mutex> lock(_mutex);
-        updateCameraListLocked();
-        for(auto &cur : _devices)
-            list.emplace_back(cur.GetFriendlyName().c_str());
+        return refreshDeviceTable()->friendlyNames();
     }catch(const GenericException &e) {
         syslog(e.what(), true);
     }catch(const std::exception &e){
@@ -67,15 +135,12 @@ std::vector<string> CameraSystem::getCameraList() {
     }catch(...){
         syslog("Unknown exception in getCameraList", true);
     }
-    return list;
+    return {};
 }
 
 std::vector<string> CameraSystem::getCachedCameraList() const {
-    std::vector<std::string> list;
     try{
-        std::lock_guard<std::mutex> lock(_mutex);
-        for(const auto &cur : _devices)
-            list.emplace_back(cur.GetFriendlyName().c_str());
+        return deviceTable()->friendlyNames();
     }catch(const GenericException &e) {
         syslog(e.what(), true);
     }catch(const std::exception &e){
@@ -83,17 +148,14 @@ std::vector<string> CameraSystem::getCachedCameraList() const {
     }catch(...){
         syslog("Unknown exception in getCachedCameraList", true);
     }
-    return list;
+    return {};
 }
 
 bool CameraSystem::isAccessible(const string &camera){
     try{
-        std::lock_guard<std::mutex> lock(_mutex);
-        updateCameraListLocked();
-        for(const auto& device : _devices){
-            if(camera == device.GetFriendlyName().c_str()){
-                return _tlFactory->IsDeviceAccessible(device);
-            }
+        const auto table = deviceTable();
+        if(const auto* device = table->find(DeviceKey::FriendlyName, camera)){
+            return _tlFactory->IsDeviceAccessible(*device);
         }
     }catch(const GenericException &e){
         syslog(e.what(), true);
@@ -106,25 +168,191 @@ bool CameraSystem::isAccessible(const string &camera){
 }
 
 CDeviceInfo CameraSystem::getCameraInfo(const string &cameraName) {
+    if(auto device = findDevice(DeviceKey::FriendlyName, cameraName)){
+        return *device;
+    }
+    syslog("No matched information found for " + cameraName + ".", true);
+    return {};
+}
+
+std::optional<CDeviceInfo> CameraSystem::findDevice(const DeviceKey key, const std::string& value) const
+{
+    const auto table = deviceTable();
+    const auto* device = table->find(key, value);
+    return device ? std::optional<CDeviceInfo>(*device) : std::nullopt;
+}
+
+std::shared_ptr<const DeviceTable> CameraSystem::deviceTable() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _deviceTable;
+}
+
+void CameraSystem::setCameraListTtl(const std::chrono::milliseconds ttl)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _deviceTableTtl = std::max(ttl, std::chrono::milliseconds(0));
+}
+
+std::chrono::milliseconds CameraSystem::cameraListTtl() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _deviceTableTtl;
+}
+
+bool CameraSystem::refreshCameraListIfStale()
+{
     try{
-        std::lock_guard<std::mutex> lock(_mutex);
-        updateCameraListLocked();
-        syslog("Searching for the device information of " + cameraName + "...");
-        for(auto &cur:_devices){
-            if(cameraName == cur.GetFriendlyName().c_str()){
-                syslog("Matched information found.");
-                return cur;
-            }
-        }
+        return refreshDeviceTable(true) != nullptr;
     }catch(const GenericException &e){
         syslog(e.what(), true);
     }catch(const std::exception &e){
         syslog(e.what(), true);
     }catch(...){
-        syslog("Unknown exception in getCameraInfo", true);
+        syslog("Unknown exception in refreshCameraListIfStale", true);
     }
-    syslog("No matched information found. ", true);
-    return {};
+    return false;
+}
+
+std::size_t CameraSystem::enumerateDevices(DeviceInfoList_t& devices)
+{
+    const auto filter = enumerationFilter();
+    if(filter.transportLayers.empty()){
+        _tlFactory->EnumerateDevices(devices);
+    }else{
+        std::vector<EnumerationFilter::TransportLayer> layers;
+        for(const auto layer : filter.transportLayers){
+            if(std::find(layers.begin(), layers.end(), layer) == layers.end()) layers.push_back(layer);
+        }
+        std::vector<DeviceInfoList_t> found(layers.size());
+        std::vector<std::string> errors(layers.size());
+        const auto enumerate = [this, &layers, &found, &errors](const std::size_t index){
+            try{
+                auto* layer = transportLayer(layers[index]);
+                if(!layer){
+                    errors[index] = "not installed";
+                    return;
+                }
+                layer->EnumerateDevices(found[index]);
+            }catch(const GenericException &e){
+                errors[index] = e.GetDescription();
+            }catch(const std::exception &e){
+                errors[index] = e.what();
+            }
+        };
+        std::vector<std::thread> workers;
+        workers.reserve(layers.size() - 1);
+        for(std::size_t index = 1; index < layers.size(); ++index){
+            workers.emplace_back(enumerate, index);
+        }
+        enumerate(0);
+        for(auto& worker : workers){
+            worker.join();
+        }
+
+        std::size_t failed = 0;
+        for(std::size_t index = 0; index < layers.size(); ++index){
+            if(errors[index].empty()){
+                devices.insert(devices.end(), found[index].begin(), found[index].end());
+                continue;
+            }
+            ++failed;
+            syslog(std::string("[WARN] Enumerating ") + deviceClassName(layers[index]) + " failed: " + errors[index], true);
+        }
+        // Keep the previous table rather than reporting every device as removed.
+        if(failed == layers.size()){
+            throw std::runtime_error("No transport layer could be enumerated.");
+        }
+    }
+
+    devices.erase(std::remove_if(devices.begin(), devices.end(), [&filter](const CDeviceInfo& device){
+        return !filter.allows(device);
+    }), devices.end());
+    return devices.size();
+}
+
+ITransportLayer* CameraSystem::transportLayer(const EnumerationFilter::TransportLayer transportLayer)
+{
+    auto& loaded = _transportLayers.at(static_cast<std::size_t>(transportLayer));
+    std::call_once(loaded.loaded, [this, &loaded, transportLayer]{
+        try{
+            loaded.transportLayer = _tlFactory->CreateTl(deviceClassName(transportLayer));
+        }catch(const GenericException &e){
+            syslog(e.GetDescription(), true);
+        }
+    });
+    return loaded.transportLayer;
+}
+
+void CameraSystem::setEnumerationFilter(EnumerationFilter filter)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _enumerationFilter = std::move(filter);
+}
+
+EnumerationFilter CameraSystem::enumerationFilter() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _enumerationFilter;
+}
+
+CallbackRegistry<CameraSystem::DeviceListCallback>::Id CameraSystem::registerDeviceListCallback(DeviceListCallback cb)
+{
+    return _deviceListCallbacks.add(std::move(cb));
+}
+
+bool CameraSystem::deregisterDeviceListCallback(const CallbackRegistry<DeviceListCallback>::Id id)
+{
+    return _deviceListCallbacks.remove(id);
+}
+
+bool CameraSystem::enableDiscovery(const std::chrono::milliseconds interval)
+{
+    std::lock_guard<std::mutex> lock(_discoveryMutex);
+    if(_discoveryThread.joinable()) return false;
+    _discoveryInterval = std::max(interval, std::chrono::milliseconds(1));
+    _discoveryStopping = false;
+    _discoveryThread = std::thread([this]{ runDiscovery(); });
+    syslog("Device discovery enabled: intervalMs=" + to_string(_discoveryInterval.count()) + ".");
+    return true;
+}
+
+void CameraSystem::disableDiscovery()
+{
+    std::thread discoveryThread;
+    {
+        std::lock_guard<std::mutex> lock(_discoveryMutex);
+        if(!_discoveryThread.joinable()) return;
+        _discoveryStopping = true;
+        discoveryThread = std::move(_discoveryThread);
+    }
+    _discoveryWake.notify_all();
+    discoveryThread.join();
+    syslog("Device discovery disabled.");
+}
+
+bool CameraSystem::isDiscoveryEnabled() const
+{
+    std::lock_guard<std::mutex> lock(_discoveryMutex);
+    return _discoveryThread.joinable();
+}
+
+void CameraSystem::runDiscovery()
+{
+    applyCurrentThreadSettings({}, "cam-discovery");
+    std::unique_lock<std::mutex> lock(_discoveryMutex);
+    while(!_discoveryStopping){
+        lock.unlock();
+        try{
+            refreshDeviceTable(false, true);
+        }catch(const GenericException &e){
+            syslog(std::string("[WARN] Device discovery failed: ") + e.GetDescription(), true);
+        }catch(const std::exception &e){
+            syslog(std::string("[WARN] Device discovery failed: ") + e.what(), true);
+        }
+        lock.lock();
+        _discoveryWake.wait_for(lock, _discoveryInterval, [this]{ return _discoveryStopping; });
+    }
 }
 
 Camera *CameraSystem::addCamera()
@@ -165,31 +393,174 @@ Camera *CameraSystem::getCamera(const int allottedNumber) const {
 
 IPylonDevice* CameraSystem::createDevice(const string &cameraName)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-
+    // The table lookup takes the lock only to copy the table pointer;
+    // CTlFactory::CreateDevice is thread-safe, so parallel opens do not queue behind each other.
+    const auto table = deviceTable();
+    const CDeviceInfo* device = nullptr;
     if(cameraName.empty()){
-        for(const auto& device : _devices){
-            if(_tlFactory->IsDeviceAccessible(device)){
-                return _tlFactory->CreateDevice(device);
-            }
+        const auto& devices = table->devices();
+        const auto iter = std::find_if(devices.begin(), devices.end(), [this](const CDeviceInfo& candidate){
+            return _tlFactory->IsDeviceAccessible(candidate);
+        });
+        if(iter == devices.end()){
+            throw std::runtime_error("No cached accessible camera device found. Refresh the camera list first.");
+        }
+        device = &*iter;
+    }else{
+        device = table->find(DeviceKey::FriendlyName, cameraName);
+        if(!device){
+            throw std::runtime_error("Camera device not found in cached list: " + cameraName);
+        }
+        if(!_tlFactory->IsDeviceAccessible(*device)){
+            throw std::runtime_error("Camera device is not accessible: " + cameraName);
         }
-        throw std::runtime_error("No cached accessible camera device found. Refresh the camera list first.");
     }
+    return _tlFactory->CreateDevice(*device);
+}
+
+std::vector<CameraSystem::OpenResult> CameraSystem::openAll(const std::vector<std::string>& cameraNames,
+                                                            const std::size_t concurrency,
+                                                            const bool closeAllOnFailure)
+{
+    const auto started = std::chrono::steady_clock::now();
+    std::vector<OpenResult> results(cameraNames.size());
 
-    for(const auto& device : _devices){
-        if(cameraName == device.GetFriendlyName().c_str()){
-            if(!_tlFactory->IsDeviceAccessible(device)){
-                throw std::runtime_error("Camera device is not accessible: " + cameraName);
-            }
-            return _tlFactory->CreateDevice(device);
+    {
+        const auto table = deviceTable();
+        const bool cached = std::all_of(cameraNames.begin(), cameraNames.end(), [&table](const std::string& name){
+            return table->find(DeviceKey::FriendlyName, name) != nullptr;
+        });
+        if(!cached){
+            updateCameraList();
         }
     }
 
-    throw std::runtime_error("Camera device not found in cached list: " + cameraName);
+    for(std::size_t index = 0; index < cameraNames.size(); ++index){
+        results[index].name = cameraNames[index];
+        const auto first = std::find(cameraNames.begin(), cameraNames.end(), cameraNames[index]);
+        if(cameraNames[index].empty() || static_cast<std::size_t>(first - cameraNames.begin()) != index){
+            results[index].timing.failedPhase = "createDevice";
+            results[index].timing.error = "Camera name is empty or listed twice: " + cameraNames[index];
+            continue;
+        }
+        results[index].camera = addCamera();
+    }
+
+    std::atomic<std::size_t> next{0};
+    const auto worker = [&results, &next]{
+        for(auto index = next.fetch_add(1); index < results.size(); index = next.fetch_add(1)){
+            auto& result = results[index];
+            if(!result.camera) continue;
+            result.opened = result.camera->open(result.name);
+            result.timing = result.camera->lastOpenTiming();
+        }
+    };
+    const auto threadCount = std::clamp<std::size_t>(concurrency, 1, std::max<std::size_t>(1, results.size()));
+    std::vector<std::thread> workers;
+    workers.reserve(threadCount - 1);
+    for(std::size_t index = 1; index < threadCount; ++index){
+        workers.emplace_back(worker);
+    }
+    worker();
+    for(auto& thread : workers){
+        thread.join();
+    }
+
+    const bool anyFailed = std::any_of(results.begin(), results.end(), [](const OpenResult& result){
+        return !result.opened;
+    });
+    std::size_t openedCount = 0;
+    for(auto& result : results){
+        if(result.opened && !(anyFailed && closeAllOnFailure)){
+            ++openedCount;
+            continue;
+        }
+        if(result.camera){
+            // Failed opens already released their device; removal also closes rolled-back cameras.
+            removeCamera(result.camera);
+            result.camera = nullptr;
+            result.opened = false;
+        }
+        if(!result.timing.error.empty()){
+            syslog("[WARN] openAll: " + result.name + " failed in " + result.timing.failedPhase
+                + ": " + result.timing.error, true);
+        }
+    }
+
+    const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started).count();
+    syslog("[DEBUG] openAll: opened=" + to_string(openedCount) + "/" + to_string(results.size())
+        + ", concurrency=" + to_string(threadCount) + ", elapsedMs=" + to_string(elapsedMs) + ".");
+    return results;
 }
 
-void CameraSystem::syslog(const string &message, const bool warning)
+std::shared_ptr<CaptureGroup> CameraSystem::createGroup(const std::vector<Camera*>& cameras,
+                                                      const CaptureGroupPolicy& policy)
 {
-    if(!warning) cout << "[Camera System] " << message << endl;
-    else cerr << "[Camera System] " << message << endl;
+    try{
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for(const auto* camera : cameras){
+                if(std::find(_cameraList.begin(), _cameraList.end(), camera) == _cameraList.end()){
+                    throw std::invalid_argument("Capture group camera is not owned by this camera system.");
+                }
+            }
+        }
+        auto group = CaptureGroup::create(cameras, policy);
+        syslog("Capture group created with " + to_string(cameras.size()) + " camera(s).");
+        return group;
+    }catch(const GenericException &e){
+        syslog(e.GetDescription(), true);
+    }catch(const std::exception &e){
+        syslog(e.what(), true);
+    }
+    return nullptr;
 }
+
+bool CameraSystem::enableAcquisitionReactor(const AcquisitionReactorOptions& options)
+{
+    std::lock_guard<std::mutex> lock(_reactorMutex);
+    if(_reactor) return false;
+    _reactor = std::make_shared<AcquisitionReactor>(options);
+    syslog("Acquisition reactor enabled: pollers=" + to_string(std::max<std::size_t>(1, options.pollerThreads))
+        + ", workers=" + to_string(std::max<std::size_t>(1, options.workerThreads)) + ".");
+    return true;
+}
+
+void CameraSystem::disableAcquisitionReactor()
+{
+    std::shared_ptr<AcquisitionReactor> reactor;
+    {
+        std::lock_guard<std::mutex> lock(_reactorMutex);
+        reactor = std::move(_reactor);
+    }
+    // Destroyed outside the lock so concurrent grab() calls fall back to worker threads instead of blocking.
+    reactor.reset();
+}
+
+std::shared_ptr<AcquisitionReactor> CameraSystem::acquisitionReactor() const
+{
+    std::lock_guard<std::mutex> lock(_reactorMutex);
+    return _reactor;
+}
+
+void CameraSystem::setDeviceProfileCachePath(const std::string& path)
+{
+    auto cache = path.empty() ? nullptr : std::make_shared<DeviceProfileCache>(path);
+    std::lock_guard<std::mutex> lock(_profileCacheMutex);
+    _profileCache = std::move(cache);
+}
+
+std::shared_ptr<DeviceProfileCache> CameraSystem::deviceProfileCache() const
+{
+    std::lock_guard<std::mutex> lock(_profileCacheMutex);
+    return _profileCache;
+}
+
+void CameraSystem::syslog(std::string message, const bool warning)
+{
+    auto level = warning ? LogLevel::Warning : LogLevel::Info;
+    if(message.compare(0, 7, "[DEBUG]") == 0) level = LogLevel::Debug;
+    auto& logger = Logger::instance();
+    if(logger.enabled(level)) logger.log(level, std::move(message));
+}
@@ -10,10 +10,23 @@
  */
 
 #include <pylon/PylonIncludes.h>
+#include "AcquisitionReactor.h"
 #include "Camera.h"
+#include "CaptureGroup.h"
+#include "DeviceProfileCache.h"
+#include "DeviceTable.h"
+#include "Logger.h"
 
+#include <array>
+#include <chrono>
+#include <condition_variable>
 #include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <optional>
+#include <thread>
 
 using namespace Pylon;
 using namespace std;
@@ -23,28 +36,164 @@ public:
     CameraSystem();
     ~CameraSystem();
 
+    /** Enumerates devices and replaces the device table; lookups keep using the old table until it is done. */
     void updateCameraList();
+    /** Enumerates devices and returns their friendly names. */
     std::vector<std::string> getCameraList();
     std::vector<std::string> getCachedCameraList() const;
+    /** Looks the camera up in the device table without enumerating; call `updateCameraList()` first to see new devices. */
     bool isAccessible(const std::string &camera);
 
+    /** Device table lookup by friendly name; never enumerates. Returns an empty info when unknown. */
     CDeviceInfo getCameraInfo(const std::string &cameraName);
+    /** Device table lookup by any `DeviceKey`; never enumerates. */
+    std::optional<CDeviceInfo> findDevice(DeviceKey key, const std::string& value) const;
+    /** The current device table; it stays valid and unchanged while later enumerations replace it. */
+    std::shared_ptr<const DeviceTable> deviceTable() const;
+
+    /**
+     * @brief Sets how long an enumeration stays fresh for `refreshCameraListIfStale()`.
+     *
+     * Zero, the default, keeps the table until `updateCameraList()` runs. The
+     * TTL never triggers enumeration by itself.
+     */
+    void setCameraListTtl(std::chrono::milliseconds ttl);
+    std::chrono::milliseconds cameraListTtl() const;
+    /** Enumerates only when the table was never filled or is older than the TTL; `true` when it did. */
+    bool refreshCameraListIfStale();
+
+    /**
+     * @brief Limits later enumerations to some transport layers and allow-listed devices.
+     *
+     * Takes effect with the next enumeration; the current device table is kept.
+     * A transport layer is loaded the first time a filter enumerates it.
+     */
+    void setEnumerationFilter(EnumerationFilter filter);
+    EnumerationFilter enumerationFilter() const;
+
+    using DeviceListCallback = std::function<void(const DeviceListDiff& diff)>;
+    /**
+     * @brief Receives the added, removed, and changed devices of every enumeration that changed the table.
+     *
+     * Runs on an enumerating thread after the enumeration lock is released, one
+     * diff at a time and in enumeration order, so the callback may call
+     * `getCameraList()`, `updateCameraList()`, or `refreshCameraListIfStale()`;
+     * the diff of such a nested enumeration is delivered after the current one.
+     */
+    CallbackRegistry<DeviceListCallback>::Id registerDeviceListCallback(DeviceListCallback cb);
+    bool deregisterDeviceListCallback(CallbackRegistry<DeviceListCallback>::Id id);
+
+    /**
+     * @brief Enumerates on a `cam-discovery` thread every `interval`, keeping the device table current.
+     * @return `false` when discovery is already running.
+     */
+    bool enableDiscovery(std::chrono::milliseconds interval = std::chrono::seconds(2));
+    /** Waits for an enumeration in progress and joins the thread. */
+    void disableDiscovery();
+    bool isDiscoveryEnabled() const;
 
     Camera* addCamera();
     void removeCamera(Camera* camera);
     Camera* getCamera(int allottedNumber) const;
     IPylonDevice *createDevice(const std::string &cameraName="");
 
-    static void syslog(const std::string &message, bool warning=false);
+    struct OpenResult
+    {
+        std::string name;
+        /** Owned by this system; null when the open failed or was rolled back. */
+        Camera* camera = nullptr;
+        bool opened = false;
+        Camera::OpenTiming timing;
+    };
+    /**
+     * @brief Creates and opens one camera per friendly name on up to `concurrency` threads.
+     *
+     * The device list is refreshed first when a name is not cached. Cameras that
+     * fail to open are removed again; with `closeAllOnFailure`, one failure
+     * removes every camera of the call.
+     * @return One result per name, in input order, with per-phase open timing.
+     */
+    std::vector<OpenResult> openAll(const std::vector<std::string>& cameraNames,
+                                    std::size_t concurrency = 4,
+                                    bool closeAllOnFailure = false);
+    /**
+     * @brief Creates a synchronized capture group over cameras owned by this system.
+     * @return `nullptr` when a camera is unknown, listed twice, or null.
+     */
+    std::shared_ptr<CaptureGroup> createGroup(const std::vector<Camera*>& cameras,
+                                              const CaptureGroupPolicy& policy = {});
+
+    /**
+     * @brief Receives results of cameras started afterwards on shared reactor threads instead of one worker per camera.
+     * @note A free-run camera waiting for a credit parks until `ready()` returns one
+     *       instead of holding a worker. Cameras with a `Block` delivery queue keep
+     *       their own worker thread, which is logged once per camera.
+     * @return `false` when a reactor is already enabled.
+     */
+    bool enableAcquisitionReactor(const AcquisitionReactorOptions& options = {});
+    /** Stops every camera grabbing through the reactor and joins its threads. */
+    void disableAcquisitionReactor();
+    std::shared_ptr<AcquisitionReactor> acquisitionReactor() const;
+
+    /**
+     * @brief Persists detected device families, component layouts, and 3D profiles in `path`.
+     *
+     * Later opens of a camera with the same serial number, firmware version, and
+     * node map skip family probing and calibration reads. An empty path disables the cache.
+     */
+    void setDeviceProfileCachePath(const std::string& path);
+    std::shared_ptr<DeviceProfileCache> deviceProfileCache() const;
+
+    /**
+     * @brief Queues a message on the asynchronous `Logger`; never blocks on output.
+     *
+     * Messages starting with `[DEBUG]` log at `LogLevel::Debug`, warnings at
+     * `LogLevel::Warning`, everything else at `LogLevel::Info`. Hot paths use
+     * the `CAMERA_LOG*` macros so disabled messages are not even formatted.
+     */
+    static void syslog(std::string message, bool warning=false);
 
 private:
-    void updateCameraListLocked();
+    /** Enumerates outside `_mutex`; with `onlyIfStale`, skips when another thread refreshed meanwhile. */
+    std::shared_ptr<const DeviceTable> refreshDeviceTable(bool onlyIfStale = false, bool background = false);
+    /** Delivers queued diffs unless another thread, or an outer frame of this one, is already delivering. */
+    void dispatchDeviceListDiffs();
+    void runDiscovery();
+    /** Enumerates the filter's transport layers in parallel, or all of them through the factory, and applies the allow-lists. */
+    std::size_t enumerateDevices(DeviceInfoList_t& devices);
+    /** Loads the transport layer on first use; null when it is not installed. */
+    ITransportLayer* transportLayer(EnumerationFilter::TransportLayer transportLayer);
 
     CTlFactory *_tlFactory = nullptr;
-    DeviceInfoList_t _devices;
+    // Replaced as a whole on every enumeration, so readers copy the pointer under _mutex and look up without it.
+    std::shared_ptr<const DeviceTable> _deviceTable = std::make_shared<const DeviceTable>();
+    std::chrono::milliseconds _deviceTableTtl{0};
+    EnumerationFilter _enumerationFilter;
+    struct LoadedTransportLayer
+    {
+        std::once_flag loaded;
+        ITransportLayer* transportLayer = nullptr;
+    };
+    // Indexed by EnumerationFilter::TransportLayer; released in the destructor.
+    std::array<LoadedTransportLayer, 4> _transportLayers;
+    // Serializes enumerations; taken before _mutex, never while holding it.
+    std::mutex _enumerationMutex;
+    CallbackRegistry<DeviceListCallback> _deviceListCallbacks;
+    std::mutex _deviceListDispatchMutex;
+    std::deque<DeviceListDiff> _pendingDeviceListDiffs;
+    bool _dispatchingDeviceList = false;
+    std::thread _discoveryThread;
+    mutable std::mutex _discoveryMutex;
+    std::condition_variable _discoveryWake;
+    std::chrono::milliseconds _discoveryInterval{0};
+    bool _discoveryStopping = false;
     std::vector<Camera*> _cameraList;
     std::size_t _nextCameraNumber = 0;
     mutable std::mutex _mutex;
+    std::shared_ptr<AcquisitionReactor> _reactor;
+    mutable std::mutex _reactorMutex;
+    std::shared_ptr<DeviceProfileCache> _profileCache;
+    mutable std::mutex _profileCacheMutex;
 };
 
 
@@ -0,0 +1,440 @@
+#include "CaptureGroup.h"
+#include "CameraSystem.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+// How far from the counter's top and bottom a backward step still counts as a
+// wrap, and how far back any other step may go before it counts as a restart.
+constexpr std::uint64_t KeyWrapWindow = 1024;
+
+void configureMemberTrigger(GenApi::INodeMap& nodeMap, const CaptureGroupPolicy& policy)
+{
+    Pylon::CEnumParameter triggerSelector(nodeMap, "TriggerSelector");
+    if(triggerSelector.IsWritable()){
+        triggerSelector.TrySetValue("FrameStart");
+    }
+    Pylon::CEnumParameter(nodeMap, "TriggerMode").TrySetValue("On");
+    const auto* source = policy.trigger == CaptureGroupPolicy::Trigger::Software
+        ? "Software"
+        : policy.hardwareTriggerSource.c_str();
+    if(!Pylon::CEnumParameter(nodeMap, "TriggerSource").TrySetValue(source)){
+        CameraSystem::syslog(std::string("[WARN] Capture group could not select trigger source ") + source + ".", true);
+    }
+}
+
+}
+
+std::shared_ptr<CaptureGroup> CaptureGroup::create(std::vector<Camera*> cameras, const CaptureGroupPolicy& policy)
+{
+    if(cameras.empty()){
+        throw std::invalid_argument("Capture group needs at least one camera.");
+    }
+    for(std::size_t index = 0; index < cameras.size(); ++index){
+        if(!cameras[index]){
+            throw std::invalid_argument("Capture group camera " + std::to_string(index) + " is null.");
+        }
+        if(std::find(cameras.begin(), cameras.begin() + index, cameras[index]) != cameras.begin() + index){
+            throw std::invalid_argument("Capture group lists camera " + std::to_string(index) + " twice.");
+        }
+    }
+
+    std::shared_ptr<CaptureGroup> group(new CaptureGroup(std::move(cameras), policy));
+    const std::weak_ptr<CaptureGroup> weakGroup = group;
+    for(std::size_t member = 0; member < group->_cameras.size(); ++member){
+        group->_frameCallbackIds.push_back(group->_cameras[member]->registerFrameCallback(
+            [weakGroup, member](const FrameHandle& frame){
+                if(const auto strongGroup = weakGroup.lock()){
+                    strongGroup->onFrame(member, frame);
+                }
+            }));
+    }
+    group->_timer = std::thread([raw = group.get(), weakGroup]{
+        raw->runTimer(weakGroup);
+    });
+    return group;
+}
+
+CaptureGroup::CaptureGroup(std::vector<Camera*> cameras, const CaptureGroupPolicy& policy)
+    : _cameras(std::move(cameras))
+    , _policy(policy)
+{
+    _slots.resize(std::max<std::size_t>(1, policy.slotCount));
+    resetSlotsLocked();
+}
+
+CaptureGroup::~CaptureGroup()
+{
+    for(std::size_t member = 0; member < _cameras.size() && member < _frameCallbackIds.size(); ++member){
+        _cameras[member]->deregisterFrameCallback(_frameCallbackIds[member]);
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _timerCondition.notify_all();
+    if(_timer.joinable()){
+        if(_timer.get_id() == std::this_thread::get_id()){
+            _timer.detach();
+        }else{
+            _timer.join();
+        }
+    }
+}
+
+CaptureGroup::CallbackId CaptureGroup::registerCallback(MultiFrameCallback callback)
+{
+    return _callbacks.add(std::move(callback));
+}
+
+bool CaptureGroup::deregisterCallback(const CallbackId id)
+{
+    return _callbacks.remove(id);
+}
+
+bool CaptureGroup::start(const size_t frames)
+{
+    for(std::size_t member = 0; member < _cameras.size(); ++member){
+        if(!_cameras[member]->isOpened()){
+            CameraSystem::syslog("[WARN] Capture group member " + std::to_string(member) + " is not open.", true);
+            return false;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        resetSlotsLocked();
+    }
+    try{
+        if(_policy.configureTrigger){
+            for(auto* camera : _cameras){
+                configureMemberTrigger(camera->getNodeMap(), _policy);
+            }
+        }
+    }catch(const GenericException &e){
+        CameraSystem::syslog(std::string("[WARN] Capture group trigger setup failed: ") + e.GetDescription(), true);
+        return false;
+    }
+
+    for(auto* camera : _cameras){
+        camera->grab(frames);
+    }
+    CameraSystem::syslog("[DEBUG] Capture group armed: members=" + std::to_string(_cameras.size())
+        + ", trigger=" + (_policy.trigger == CaptureGroupPolicy::Trigger::Software ? "Software" : _policy.hardwareTriggerSource)
+        + ", slots=" + std::to_string(_slots.size()) + ".");
+    return true;
+}
+
+void CaptureGroup::stop()
+{
+    // Signal every member first so their workers wind down in parallel.
+    for(auto* camera : _cameras){
+        camera->requestStop();
+    }
+    for(auto* camera : _cameras){
+        camera->stop();
+    }
+
+    std::vector<MultiFrame> closed;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        closeExpiredLocked(FrameTiming::now(), true, closed);
+    }
+    deliver(closed);
+}
+
+size_t CaptureGroup::trigger(const std::chrono::milliseconds readyTimeout)
+{
+    size_t triggered = 0;
+    size_t failures = 0;
+    for(auto* camera : _cameras){
+        if(camera->executeSoftwareTrigger(readyTimeout)){
+            ++triggered;
+        }else{
+            ++failures;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_statistics.triggers;
+    _statistics.triggerFailures += failures;
+    return triggered;
+}
+
+CaptureGroupStatistics CaptureGroup::statistics() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _statistics;
+}
+
+void CaptureGroup::onFrame(const std::size_t member, const FrameHandle& frame)
+{
+    auto key = matchKey(frame);
+    const auto now = FrameTiming::now();
+    std::vector<MultiFrame> closed;
+    bool opened = false;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if(_stopping) return;
+
+        if(_policy.match != CaptureGroupPolicy::Match::TimestampWindow){
+            key = unwrapKeyLocked(key, now, closed);
+        }
+        auto* slot = findSlotLocked(member, key, now, closed);
+        if(!slot || slot->frames[member]){
+            ++_statistics.droppedFrames;
+        }else{
+            opened = slot->count == 0;
+            slot->frames[member] = frame;
+            if(++slot->count == _cameras.size()){
+                closeSlotLocked(*slot, closed);
+            }
+        }
+    }
+    if(opened){
+        _timerCondition.notify_one();
+    }
+    deliver(closed);
+}
+
+std::int64_t CaptureGroup::matchKey(const FrameHandle& frame) const
+{
+    switch(_policy.match){
+    case CaptureGroupPolicy::Match::BlockId:{
+        const auto blockId = frame.grabResult()->GetBlockID();
+        if(blockId == std::numeric_limits<uint64_t>::max()) return static_cast<std::int64_t>(frame.sequence());
+        return static_cast<std::int64_t>(blockId);
+    }
+    case CaptureGroupPolicy::Match::FrameCounter:
+        return frame.chunkMetadata().hasFrameCounter
+            ? frame.chunkMetadata().frameCounter
+            : static_cast<std::int64_t>(frame.sequence());
+    case CaptureGroupPolicy::Match::TimestampWindow:
+        if(!_policy.useDeviceTimestamps) return frame.timing().hostReceiveNs;
+        return static_cast<std::int64_t>(frame.chunkMetadata().hasTimestamp
+            ? frame.chunkMetadata().timestamp
+            : frame.timing().deviceTimestamp);
+    case CaptureGroupPolicy::Match::Sequence:
+    default:
+        return static_cast<std::int64_t>(frame.sequence());
+    }
+}
+
+// GigE Vision 1.x block IDs wrap from 65535 to 1 and chunk frame counters at
+// 16 or 32 bits, so raw keys are mapped onto a monotonic axis. A small raw key
+// right after the newest one neared the counter's top is the next lap; a key
+// near the top while the newest one is just past the bottom is a straggler from
+// the previous lap. Members wrap at slightly different times but agree on the
+// lap. Any other step back beyond the window is a restart: pending sets close
+// and matching starts over from the new key.
+std::int64_t CaptureGroup::unwrapKeyLocked(const std::int64_t rawKey,
+                                           const std::int64_t now,
+                                           std::vector<MultiFrame>& closed)
+{
+    const auto raw = static_cast<std::uint64_t>(rawKey);
+    _maxRawKey = std::max(_maxRawKey, raw);
+    if(!_hasKeyHead){
+        _keyHead = rawKey;
+        _hasKeyHead = true;
+        return rawKey;
+    }
+
+    auto key = rawKey;
+    const std::uint64_t period = _maxRawKey <= 0xFFFF ? 0x10000ULL
+        : _maxRawKey <= 0xFFFFFFFFULL ? 0x100000000ULL : 0;
+    if(period){
+        const auto lap = static_cast<std::int64_t>(period);
+        const auto headRaw = static_cast<std::uint64_t>(_keyHead % lap);
+        const auto base = _keyHead - static_cast<std::int64_t>(headRaw);
+        key = base + rawKey;
+        if(headRaw >= period - KeyWrapWindow && raw <= KeyWrapWindow){
+            key += lap;
+        }else if(raw >= period - KeyWrapWindow && headRaw <= KeyWrapWindow && base >= lap){
+            key -= lap;
+        }
+    }
+
+    if(key < _keyHead && static_cast<std::uint64_t>(_keyHead - key) > KeyWrapWindow){
+        ++_statistics.keyRestarts;
+        closeExpiredLocked(now, true, closed);
+        _hasClosedKey = false;
+        _closedKeyWatermark = 0;
+        _keyHead = key;
+        return key;
+    }
+    _keyHead = std::max(_keyHead, key);
+    return key;
+}
+
+// Discrete keys map directly onto a slot; a slot still holding an older key is
+// closed first. Timestamp matching picks the nearest open set within the window
+// that lacks this member, or opens a new one, evicting the oldest when full.
+CaptureGroup::Slot* CaptureGroup::findSlotLocked(const std::size_t member,
+                                                 const std::int64_t key,
+                                                 const std::int64_t now,
+                                                 std::vector<MultiFrame>& closed)
+{
+    if(_policy.match != CaptureGroupPolicy::Match::TimestampWindow){
+        auto& slot = _slots[static_cast<std::uint64_t>(key) % _slots.size()];
+        if(slot.used && slot.key == key) return &slot;
+        if(_hasClosedKey && key <= _closedKeyWatermark) return nullptr;
+        if(slot.used){
+            if(key < slot.key) return nullptr;
+            ++_statistics.slotEvictions;
+            closeSlotLocked(slot, closed);
+        }
+        openSlotLocked(slot, key, now);
+        return &slot;
+    }
+
+    const auto window = _policy.timestampWindow.count();
+    Slot* nearest = nullptr;
+    Slot* freeSlot = nullptr;
+    Slot* oldest = nullptr;
+    auto nearestDistance = std::numeric_limits<std::int64_t>::max();
+    for(auto& slot : _slots){
+        if(!slot.used){
+            if(!freeSlot) freeSlot = &slot;
+            continue;
+        }
+        if(!oldest || slot.openedNs < oldest->openedNs) oldest = &slot;
+        if(slot.frames[member]) continue;
+        const auto distance = key > slot.key ? key - slot.key : slot.key - key;
+        if(distance <= window && distance < nearestDistance){
+            nearest = &slot;
+            nearestDistance = distance;
+        }
+    }
+    if(nearest) return nearest;
+    if(!freeSlot){
+        ++_statistics.slotEvictions;
+        closeSlotLocked(*oldest, closed);
+        freeSlot = oldest;
+    }
+    openSlotLocked(*freeSlot, key, now);
+    return freeSlot;
+}
+
+void CaptureGroup::openSlotLocked(Slot& slot, const std::int64_t key, const std::int64_t now)
+{
+    slot.used = true;
+    slot.key = key;
+    slot.openedNs = now;
+    slot.count = 0;
+}
+
+void CaptureGroup::closeSlotLocked(Slot& slot, std::vector<MultiFrame>& closed)
+{
+    const bool complete = slot.count == _cameras.size();
+    if(_policy.match != CaptureGroupPolicy::Match::TimestampWindow){
+        _closedKeyWatermark = _hasClosedKey ? std::max(_closedKeyWatermark, slot.key) : slot.key;
+        _hasClosedKey = true;
+    }
+
+    auto earliest = std::numeric_limits<std::int64_t>::max();
+    auto latest = std::numeric_limits<std::int64_t>::min();
+    for(const auto& frame : slot.frames){
+        if(!frame) continue;
+        const auto received = frame.timing().hostReceiveNs;
+        earliest = std::min(earliest, received);
+        latest = std::max(latest, received);
+    }
+    const auto skew = slot.count > 0 ? latest - earliest : 0;
+
+    if(complete){
+        ++_statistics.completeSets;
+        _statistics.maxSkewNs = std::max(_statistics.maxSkewNs, skew);
+    }else{
+        ++_statistics.incompleteSets;
+    }
+    if(complete || _policy.deliverIncomplete){
+        MultiFrame set;
+        set.index = _nextIndex++;
+        set.frames = std::move(slot.frames);
+        set.complete = complete;
+        set.skewNs = skew;
+        closed.push_back(std::move(set));
+    }
+
+    slot.frames.assign(_cameras.size(), FrameHandle());
+    slot.used = false;
+    slot.count = 0;
+}
+
+void CaptureGroup::closeExpiredLocked(const std::int64_t now, const bool all, std::vector<MultiFrame>& closed)
+{
+    const auto timeout = std::chrono::duration_cast<std::chrono::nanoseconds>(_policy.incompleteTimeout).count();
+    for(auto& slot : _slots){
+        if(slot.used && (all || now - slot.openedNs >= timeout)){
+            closeSlotLocked(slot, closed);
+        }
+    }
+}
+
+void CaptureGroup::resetSlotsLocked()
+{
+    for(auto& slot : _slots){
+        slot.used = false;
+        slot.count = 0;
+        slot.frames.assign(_cameras.size(), FrameHandle());
+    }
+    _hasClosedKey = false;
+    _closedKeyWatermark = 0;
+    _hasKeyHead = false;
+    _keyHead = 0;
+    _maxRawKey = 0;
+}
+
+void CaptureGroup::deliver(const std::vector<MultiFrame>& sets)
+{
+    for(const auto& set : sets){
+        try{
+            _callbacks.dispatch(set);
+        }catch(const GenericException &e){
+            CameraSystem::syslog(std::string("[WARN] Capture group callback exception: ") + e.GetDescription(), true);
+        }catch(const std::exception &e){
+            CameraSystem::syslog(std::string("[WARN] Capture group callback exception: ") + e.what(), true);
+        }
+    }
+}
+
+void CaptureGroup::runTimer(const std::weak_ptr<CaptureGroup> weakGroup)
+{
+    const auto timeout = std::chrono::duration_cast<std::chrono::nanoseconds>(_policy.incompleteTimeout).count();
+    std::unique_lock<std::mutex> lock(_mutex);
+    while(!_stopping){
+        auto oldest = std::numeric_limits<std::int64_t>::max();
+        for(const auto& slot : _slots){
+            if(slot.used) oldest = std::min(oldest, slot.openedNs);
+        }
+        if(oldest == std::numeric_limits<std::int64_t>::max()){
+            _timerCondition.wait(lock);
+            continue;
+        }
+
+        const auto remaining = oldest + timeout - FrameTiming::now();
+        if(remaining > 0){
+            _timerCondition.wait_for(lock, std::chrono::nanoseconds(remaining));
+            continue;
+        }
+
+        std::vector<MultiFrame> closed;
+        closeExpiredLocked(FrameTiming::now(), false, closed);
+        if(!closed.empty()){
+            lock.unlock();
+            {
+                // Keeps the group alive while callbacks run; the last owner may be one of them.
+                const auto strongGroup = weakGroup.lock();
+                if(!strongGroup) return;
+                deliver(closed);
+            }
+            // Expired when the release above destroyed the group on this thread, which
+            // detached it, or when another thread's destructor is joining it.
+            if(weakGroup.expired()) return;
+            lock.lock();
+        }
+    }
+}
@@ -0,0 +1,185 @@
+#ifndef CAPTUREGROUP_H
+#define CAPTUREGROUP_H
+
+/**
+ * @file CaptureGroup.h
+ * @brief Synchronized capture across several cameras with per-instant frame matching.
+ *
+ * A group arms its member cameras together, fans out software triggers or relies
+ * on a shared hardware trigger, and matches the members' frames into one
+ * MultiFrame per capture instant. Matching uses a fixed ring of preallocated
+ * slots; sets that stay incomplete past the timeout are delivered partially or
+ * dropped and counted.
+ */
+
+#include "Camera.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct CaptureGroupPolicy
+{
+    enum class Trigger
+    {
+        /** `trigger()` executes a software trigger on every member. */
+        Software,
+        /** Members wait for a shared external trigger on `hardwareTriggerSource`. */
+        Hardware
+    };
+
+    enum class Match
+    {
+        /**
+         * Per-grab delivery sequence. It only counts delivered frames, so one
+         * lost frame pairs every later frame of that member with the wrong
+         * instant; use it only for transports without block IDs.
+         */
+        Sequence,
+        /** Stream block ID, unwrapped across the 16-bit GigE Vision wrap; falls back to the sequence when unsupported. */
+        BlockId,
+        /** Chunk frame counter, unwrapped like the block ID; needs chunk metadata, otherwise falls back to the sequence. */
+        FrameCounter,
+        /** Frames whose timestamps lie within `timestampWindow` of each other. */
+        TimestampWindow
+    };
+
+    Trigger trigger = Trigger::Software;
+    Match match = Match::BlockId;
+    /** Writes TriggerMode, TriggerSelector, and TriggerSource on every member in `start()`. */
+    bool configureTrigger = true;
+    std::string hardwareTriggerSource = "Line1";
+    std::chrono::nanoseconds timestampWindow = std::chrono::milliseconds(2);
+    /** Matches on device timestamps (e.g. PTP-synchronized cameras) instead of host receive time. */
+    bool useDeviceTimestamps = false;
+    /** Age after which an incomplete set is closed. */
+    std::chrono::milliseconds incompleteTimeout{100};
+    /** Delivers timed-out sets with missing members instead of dropping them. */
+    bool deliverIncomplete = false;
+    /** Capture instants that may be in flight at once. */
+    std::size_t slotCount = 8;
+};
+
+/** Frames of one capture instant, indexed like the group's camera list; missing members hold an empty handle. */
+struct MultiFrame
+{
+    std::uint64_t index = 0;
+    std::vector<FrameHandle> frames;
+    bool complete = false;
+    /** Spread of the members' host receive times in nanoseconds. */
+    std::int64_t skewNs = 0;
+};
+
+struct CaptureGroupStatistics
+{
+    std::uint64_t triggers = 0;
+    /** Software triggers a member rejected because it was not ready. */
+    std::uint64_t triggerFailures = 0;
+    std::uint64_t completeSets = 0;
+    /** Sets closed by timeout or slot reuse with at least one member missing. */
+    std::uint64_t incompleteSets = 0;
+    /** Frames that arrived for an already closed set or duplicated a member. */
+    std::uint64_t droppedFrames = 0;
+    /** Sets closed early because every slot was in use. */
+    std::uint64_t slotEvictions = 0;
+    /** Discrete keys that stepped back further than a wrap, e.g. after a stream restart; pending sets were closed. */
+    std::uint64_t keyRestarts = 0;
+    std::int64_t maxSkewNs = 0;
+};
+
+class CaptureGroup
+{
+public:
+    using CallbackId = Camera::CallbackId;
+    using MultiFrameCallback = std::function<void(const MultiFrame& frames)>;
+
+    /**
+     * @brief Creates a group and subscribes to its members' frames.
+     * @note Members must stay alive, and must not be removed from CameraSystem, while the group exists.
+     */
+    static std::shared_ptr<CaptureGroup> create(std::vector<Camera*> cameras, const CaptureGroupPolicy& policy);
+    ~CaptureGroup();
+
+    CaptureGroup(const CaptureGroup&) = delete;
+    CaptureGroup& operator=(const CaptureGroup&) = delete;
+
+    /**
+     * @brief Receives matched sets.
+     * @note Complete sets are delivered on the acquisition thread of the member
+     *       whose frame completed the set; timed-out sets on the group's timer thread.
+     */
+    CallbackId registerCallback(MultiFrameCallback callback);
+    bool deregisterCallback(CallbackId id);
+
+    /**
+     * @brief Configures triggering, clears pending sets, and arms every member.
+     * @param frames Frames per member, or zero for continuous acquisition.
+     * @return `false` when a member is not open.
+     */
+    bool start(size_t frames = 0);
+    /** Stops every member and closes pending sets. */
+    void stop();
+    /**
+     * @brief Executes a software trigger on every member back to back.
+     * @param readyTimeout Time to wait for each member to become trigger-ready.
+     * @return Number of members that were triggered.
+     */
+    size_t trigger(std::chrono::milliseconds readyTimeout = std::chrono::milliseconds(0));
+
+    [[nodiscard]] const std::vector<Camera*>& cameras() const noexcept { return _cameras; }
+    [[nodiscard]] const CaptureGroupPolicy& policy() const noexcept { return _policy; }
+    [[nodiscard]] CaptureGroupStatistics statistics() const;
+
+private:
+    struct Slot
+    {
+        bool used = false;
+        std::int64_t key = 0;
+        std::int64_t openedNs = 0;
+        std::size_t count = 0;
+        std::vector<FrameHandle> frames;
+    };
+
+    CaptureGroup(std::vector<Camera*> cameras, const CaptureGroupPolicy& policy);
+
+    void onFrame(std::size_t member, const FrameHandle& frame);
+    std::int64_t matchKey(const FrameHandle& frame) const;
+    std::int64_t unwrapKeyLocked(std::int64_t rawKey, std::int64_t now, std::vector<MultiFrame>& closed);
+    Slot* findSlotLocked(std::size_t member, std::int64_t key, std::int64_t now, std::vector<MultiFrame>& closed);
+    void openSlotLocked(Slot& slot, std::int64_t key, std::int64_t now);
+    void closeSlotLocked(Slot& slot, std::vector<MultiFrame>& closed);
+    void closeExpiredLocked(std::int64_t now, bool all, std::vector<MultiFrame>& closed);
+    void resetSlotsLocked();
+    void deliver(const std::vector<MultiFrame>& sets);
+    void runTimer(std::weak_ptr<CaptureGroup> weakGroup);
+
+    const std::vector<Camera*> _cameras;
+    const CaptureGroupPolicy _policy;
+    std::vector<CallbackId> _frameCallbackIds;
+    CallbackRegistry<MultiFrameCallback> _callbacks;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _timerCondition;
+    std::vector<Slot> _slots;
+    std::uint64_t _nextIndex = 0;
+    // Highest discrete key already closed; older stragglers are dropped.
+    std::int64_t _closedKeyWatermark = 0;
+    bool _hasClosedKey = false;
+    // Newest unwrapped discrete key, and the largest raw key that tells the counter width.
+    std::int64_t _keyHead = 0;
+    bool _hasKeyHead = false;
+    std::uint64_t _maxRawKey = 0;
+    bool _stopping = false;
+    CaptureGroupStatistics _statistics;
+
+    std::thread _timer;
+};
+
+#endif // CAPTUREGROUP_H
@@ -0,0 +1,112 @@
+#include "ChunkMetadata.h"
+
+#include <initializer_list>
+
+namespace {
+
+// Selector names differ between camera generations; unknown ones are skipped.
+const char* const ChunkSelectors[] = {
+    "ExposureTime",
+    "Gain",
+    "GainAll",
+    "Timestamp",
+    "LineStatusAll",
+    "FrameID",
+    "Framecounter",
+    "CounterValue"
+};
+
+template<typename Interface>
+Interface* findNode(GenApi::INodeMap& nodeMap, std::initializer_list<const char*> names)
+{
+    for(const auto* name : names){
+        if(auto* node = dynamic_cast<Interface*>(nodeMap.GetNode(name))){
+            return node;
+        }
+    }
+    return nullptr;
+}
+
+template<typename Interface>
+bool readNode(Interface* node, decltype(node->GetValue())& value)
+{
+    if(!node || !GenApi::IsReadable(node)) return false;
+    value = node->GetValue();
+    return true;
+}
+
+}
+
+std::vector<std::string> enableChunkMetadata(GenApi::INodeMap& nodeMap)
+{
+    std::vector<std::string> enabled;
+    auto* chunkModeNode = nodeMap.GetNode("ChunkModeActive");
+    if(!chunkModeNode || !GenApi::IsWritable(chunkModeNode)) return enabled;
+
+    Pylon::CBooleanParameter(nodeMap, "ChunkModeActive").SetValue(true);
+    Pylon::CEnumParameter chunkSelector(nodeMap, "ChunkSelector");
+    Pylon::CBooleanParameter chunkEnable(nodeMap, "ChunkEnable");
+    for(const auto* selector : ChunkSelectors){
+        if(!chunkSelector.CanSetValue(selector)) continue;
+        chunkSelector.SetValue(selector);
+        if(chunkEnable.TrySetValue(true)){
+            enabled.emplace_back(selector);
+        }
+    }
+    return enabled;
+}
+
+void disableChunkMetadata(GenApi::INodeMap& nodeMap)
+{
+    auto* chunkModeNode = nodeMap.GetNode("ChunkModeActive");
+    if(chunkModeNode && GenApi::IsWritable(chunkModeNode)){
+        Pylon::CBooleanParameter(nodeMap, "ChunkModeActive").TrySetValue(false);
+    }
+}
+
+void ChunkMetadataParser::reset(const std::size_t bufferCount)
+{
+    _handles.clear();
+    _handles.reserve(bufferCount);
+}
+
+ChunkMetadata ChunkMetadataParser::parse(const Pylon::CGrabResultPtr& result)
+{
+    ChunkMetadata metadata;
+    if(!result->IsChunkDataAvailable()) return metadata;
+
+    const auto& handles = resolve(result->GetChunkDataNodeMap());
+    metadata.hasExposureTime = readNode(handles.exposureTime, metadata.exposureTime);
+    metadata.hasGain = readNode(handles.gain, metadata.gain);
+    if(!metadata.hasGain){
+        int64_t gainRaw = 0;
+        metadata.hasGain = readNode(handles.gainRaw, gainRaw);
+        metadata.gain = static_cast<double>(gainRaw);
+    }
+    metadata.hasFrameCounter = readNode(handles.frameCounter, metadata.frameCounter);
+    int64_t timestamp = 0;
+    metadata.hasTimestamp = readNode(handles.timestamp, timestamp);
+    metadata.timestamp = static_cast<std::uint64_t>(timestamp);
+    metadata.hasLineStatus = readNode(handles.lineStatus, metadata.lineStatus);
+    return metadata;
+}
+
+// Each stream buffer owns its chunk node map, so handles are resolved once per
+// buffer and looked up by node-map address afterwards.
+const ChunkMetadataParser::Handles& ChunkMetadataParser::resolve(GenApi::INodeMap& nodeMap)
+{
+    for(const auto& handles : _handles){
+        if(handles.nodeMap == &nodeMap) return handles;
+    }
+
+    Handles handles;
+    handles.nodeMap = &nodeMap;
+    handles.exposureTime = findNode<GenApi::IFloat>(nodeMap, {"ChunkExposureTime"});
+    handles.gain = findNode<GenApi::IFloat>(nodeMap, {"ChunkGain"});
+    handles.gainRaw = findNode<GenApi::IInteger>(nodeMap, {"ChunkGainAll"});
+    handles.frameCounter = findNode<GenApi::IInteger>(nodeMap, {"ChunkFrameID", "ChunkFramecounter", "ChunkCounterValue"});
+    handles.timestamp = findNode<GenApi::IInteger>(nodeMap, {"ChunkTimestamp"});
+    handles.lineStatus = findNode<GenApi::IInteger>(nodeMap, {"ChunkLineStatusAll"});
+    _handles.push_back(handles);
+    return _handles.back();
+}
@@ -0,0 +1,75 @@
+#ifndef CHUNKMETADATA_H
+#define CHUNKMETADATA_H
+
+/**
+ * @file ChunkMetadata.h
+ * @brief Per-frame chunk data parsed once on the acquisition thread.
+ *
+ * Chunk nodes are resolved once per stream buffer and cached by the buffer's
+ * chunk node map, so steady-state parsing does no string lookups and no
+ * allocation.
+ */
+
+#include <pylon/PylonIncludes.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/** Chunk values of one frame; each `has*` flag tells whether the camera sent that chunk. */
+struct ChunkMetadata
+{
+    bool hasExposureTime = false;
+    bool hasGain = false;
+    bool hasFrameCounter = false;
+    bool hasTimestamp = false;
+    bool hasLineStatus = false;
+
+    /** Exposure time in microseconds. */
+    double exposureTime = 0.0;
+    /** Gain in dB, or raw gain units on cameras that only send `ChunkGainAll`. */
+    double gain = 0.0;
+    std::int64_t frameCounter = 0;
+    /** Device timestamp in camera ticks. */
+    std::uint64_t timestamp = 0;
+    /** Bit field of I/O line levels at exposure start. */
+    std::int64_t lineStatus = 0;
+};
+
+/**
+ * @brief Turns on chunk mode and the exposure, gain, counter, timestamp, and line-status chunks.
+ * @return Names of the chunk selectors that were enabled; empty when the camera has no chunk support.
+ * @note Must be called while the camera is open and not grabbing.
+ */
+std::vector<std::string> enableChunkMetadata(GenApi::INodeMap& nodeMap);
+/** Turns chunk mode off when the camera supports it. */
+void disableChunkMetadata(GenApi::INodeMap& nodeMap);
+
+/** Parses chunk data from grab results; used by one acquisition thread at a time. */
+class ChunkMetadataParser
+{
+public:
+    /** Drops cached node handles and reserves room for `bufferCount` stream buffers. */
+    void reset(std::size_t bufferCount);
+    /** Returns an empty record when the result carries no chunk data. */
+    ChunkMetadata parse(const Pylon::CGrabResultPtr& result);
+
+private:
+    struct Handles
+    {
+        GenApi::INodeMap* nodeMap = nullptr;
+        GenApi::IFloat* exposureTime = nullptr;
+        GenApi::IFloat* gain = nullptr;
+        GenApi::IInteger* gainRaw = nullptr;
+        GenApi::IInteger* frameCounter = nullptr;
+        GenApi::IInteger* timestamp = nullptr;
+        GenApi::IInteger* lineStatus = nullptr;
+    };
+
+    const Handles& resolve(GenApi::INodeMap& nodeMap);
+
+    std::vector<Handles> _handles;
+};
+
+#endif // CHUNKMETADATA_H
@@ -0,0 +1,371 @@
+#include "ConfigurationSnapshot.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+using SelectorContext = std::vector<std::pair<std::string, std::string>>;
+
+bool isValueNode(const GenApi::INode* node)
+{
+    switch(node->GetPrincipalInterfaceType()){
+    case GenApi::intfIInteger:
+    case GenApi::intfIFloat:
+    case GenApi::intfIBoolean:
+    case GenApi::intfIEnumeration:
+    case GenApi::intfIString:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool isReadWrite(GenApi::INode* node)
+{
+    return node && GenApi::IsReadable(node) && GenApi::IsWritable(node);
+}
+
+bool isReadable(GenApi::INode* node)
+{
+    return node && GenApi::IsReadable(node);
+}
+
+// Depth-first over the feature tree, like pylon's feature persistence, so the
+// vendor's category order provides the base dependency order.
+void collectFeatures(GenApi::INode* node,
+                     std::vector<GenApi::INode*>& features,
+                     std::unordered_set<GenApi::INode*>& visited)
+{
+    if(!node || !visited.insert(node).second) return;
+    if(node->GetPrincipalInterfaceType() == GenApi::intfICategory){
+        GenApi::NodeList_t children;
+        node->GetChildren(children);
+        for(auto* child : children){
+            collectFeatures(child, features, visited);
+        }
+        return;
+    }
+    if(node->IsFeature() && node->IsStreamable() && isValueNode(node)){
+        features.push_back(node);
+    }
+}
+
+bool isSelectorNode(GenApi::INode* node)
+{
+    const auto* selector = dynamic_cast<GenApi::ISelector*>(node);
+    return selector && selector->IsSelector();
+}
+
+// Enumeration selectors of `node`; integer selectors (e.g. LUT indexes) are
+// left at their current value.
+std::vector<GenApi::INode*> selectingEnumerations(GenApi::INode* node)
+{
+    std::vector<GenApi::INode*> selectors;
+    const auto* selector = dynamic_cast<GenApi::ISelector*>(node);
+    if(!selector) return selectors;
+    GenApi::FeatureList_t selecting;
+    selector->GetSelectingFeatures(selecting);
+    for(auto* value : selecting){
+        auto* selectingNode = value ? value->GetNode() : nullptr;
+        if(selectingNode && selectingNode->GetPrincipalInterfaceType() == GenApi::intfIEnumeration){
+            selectors.push_back(selectingNode);
+        }
+    }
+    return selectors;
+}
+
+std::vector<std::string> availableSymbolics(GenApi::INode* node)
+{
+    std::vector<std::string> symbolics;
+    auto* enumeration = dynamic_cast<GenApi::IEnumeration*>(node);
+    if(!enumeration) return symbolics;
+    GenApi::NodeList_t entries;
+    enumeration->GetEntries(entries);
+    for(auto* entry : entries){
+        auto* enumEntry = dynamic_cast<GenApi::IEnumEntry*>(entry);
+        if(enumEntry && GenApi::IsAvailable(entry)){
+            symbolics.emplace_back(enumEntry->GetSymbolic().c_str());
+        }
+    }
+    return symbolics;
+}
+
+std::string readValue(GenApi::INode* node)
+{
+    return dynamic_cast<GenApi::IValue*>(node)->ToString().c_str();
+}
+
+bool sameValue(GenApi::INode* node, const std::string& current, const std::string& wanted)
+{
+    if(current == wanted) return true;
+    if(node->GetPrincipalInterfaceType() != GenApi::intfIFloat) return false;
+    // Float strings may differ in formatting only.
+    char* currentEnd = nullptr;
+    char* wantedEnd = nullptr;
+    const double currentValue = std::strtod(current.c_str(), &currentEnd);
+    const double wantedValue = std::strtod(wanted.c_str(), &wantedEnd);
+    if(*currentEnd != '\0' || *wantedEnd != '\0') return false;
+    return std::fabs(currentValue - wantedValue) <= 1e-9 * std::max(std::fabs(currentValue), std::fabs(wantedValue));
+}
+
+// Tracks selector positions so each selector is only written when it must move.
+class SelectorState
+{
+public:
+    SelectorState(GenApi::INodeMap& nodeMap, std::size_t& writes)
+        : _nodeMap(nodeMap)
+        , _writes(writes)
+    {
+    }
+
+    bool select(const SelectorContext& context)
+    {
+        for(const auto& [name, value] : context){
+            auto* node = _nodeMap.GetNode(name.c_str());
+            if(!isReadWrite(node)) return false;
+            auto& current = position(name, node);
+            if(current == value) continue;
+            dynamic_cast<GenApi::IValue*>(node)->FromString(value.c_str());
+            current = value;
+            ++_writes;
+        }
+        return true;
+    }
+
+    void set(const std::string& name, GenApi::INode* node, const std::string& value)
+    {
+        auto& current = position(name, node);
+        if(current == value) return;
+        dynamic_cast<GenApi::IValue*>(node)->FromString(value.c_str());
+        current = value;
+    }
+
+    /** Value the selector had before this object moved it. */
+    const std::string* original(const std::string& name) const
+    {
+        const auto iter = _originals.find(name);
+        return iter == _originals.end() ? nullptr : &iter->second;
+    }
+
+    void restoreOriginals()
+    {
+        for(const auto& [name, value] : _originals){
+            auto* node = _nodeMap.GetNode(name.c_str());
+            if(!isReadWrite(node)) continue;
+            try{
+                set(name, node, value);
+            }catch(const GenICam::GenericException&){
+            }
+        }
+    }
+
+private:
+    std::string& position(const std::string& name, GenApi::INode* node)
+    {
+        auto iter = _positions.find(name);
+        if(iter == _positions.end()){
+            const auto value = readValue(node);
+            _originals.emplace(name, value);
+            iter = _positions.emplace(name, value).first;
+        }
+        return iter->second;
+    }
+
+    GenApi::INodeMap& _nodeMap;
+    std::size_t& _writes;
+    std::unordered_map<std::string, std::string> _positions;
+    std::unordered_map<std::string, std::string> _originals;
+};
+
+struct SelectedGroup
+{
+    std::vector<GenApi::INode*> selectors;
+    std::vector<GenApi::INode*> features;
+};
+
+void captureGroup(GenApi::INodeMap& nodeMap,
+                  const SelectedGroup& group,
+                  const std::size_t depth,
+                  SelectorContext& context,
+                  SelectorState& state,
+                  ConfigurationSnapshot& snapshot)
+{
+    if(depth == group.selectors.size()){
+        for(auto* feature : group.features){
+            if(!isReadWrite(feature)) continue;
+            try{
+                snapshot.entries.push_back({feature->GetName().c_str(), context, readValue(feature), false});
+            }catch(const GenICam::GenericException&){
+            }
+        }
+        return;
+    }
+
+    auto* selector = group.selectors[depth];
+    if(!isReadWrite(selector)) return;
+    const std::string name = selector->GetName().c_str();
+    // Entries are listed after the outer selector is set: nested selectors
+    // (SourceSelector, ComponentSelector) offer different values per outer value.
+    for(const auto& value : availableSymbolics(selector)){
+        context.emplace_back(name, value);
+        try{
+            if(state.select({context.back()})){
+                captureGroup(nodeMap, group, depth + 1, context, state, snapshot);
+            }
+        }catch(const GenICam::GenericException&){
+        }
+        context.pop_back();
+    }
+}
+
+std::int64_t elapsedMicroseconds(const std::chrono::steady_clock::time_point started)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count();
+}
+
+}
+
+ConfigurationSnapshot captureConfiguration(GenApi::INodeMap& nodeMap)
+{
+    ConfigurationSnapshot snapshot;
+    std::vector<GenApi::INode*> features;
+    std::unordered_set<GenApi::INode*> visited;
+    collectFeatures(nodeMap.GetNode("Root"), features, visited);
+
+    std::vector<GenApi::INode*> selectors;
+    std::vector<SelectedGroup> groups;
+    for(auto* feature : features){
+        if(isSelectorNode(feature)){
+            selectors.push_back(feature);
+            continue;
+        }
+        auto selecting = selectingEnumerations(feature);
+        if(selecting.empty()){
+            if(!isReadWrite(feature)) continue;
+            try{
+                snapshot.entries.push_back({feature->GetName().c_str(), {}, readValue(feature), false});
+            }catch(const GenICam::GenericException&){
+            }
+            continue;
+        }
+        const auto group = std::find_if(groups.begin(), groups.end(), [&selecting](const SelectedGroup& existing){
+            return existing.selectors == selecting;
+        });
+        if(group == groups.end()){
+            groups.push_back({std::move(selecting), {feature}});
+        }else{
+            group->features.push_back(feature);
+        }
+    }
+
+    std::size_t selectorWrites = 0;
+    SelectorState state(nodeMap, selectorWrites);
+    try{
+        for(const auto& group : groups){
+            SelectorContext context;
+            captureGroup(nodeMap, group, 0, context, state, snapshot);
+        }
+    }catch(...){
+        state.restoreOriginals();
+        throw;
+    }
+    state.restoreOriginals();
+
+    for(auto* selector : selectors){
+        if(!isReadWrite(selector)) continue;
+        snapshot.entries.push_back({selector->GetName().c_str(), {}, readValue(selector), true});
+    }
+    return snapshot;
+}
+
+std::vector<std::size_t> diffConfiguration(GenApi::INodeMap& nodeMap,
+                                           const ConfigurationSnapshot& snapshot,
+                                           ConfigurationApplyReport& report)
+{
+    const auto started = std::chrono::steady_clock::now();
+    std::vector<std::size_t> changed;
+    SelectorState state(nodeMap, report.selectorWrites);
+    try{
+        for(std::size_t index = 0; index < snapshot.entries.size(); ++index){
+            const auto& entry = snapshot.entries[index];
+            auto* node = nodeMap.GetNode(entry.feature.c_str());
+            // Features locked while grabbing (Width, PixelFormat, ...) still read;
+            // writeConfiguration() finds out whether they take the new value.
+            if(!isReadable(node) || !state.select(entry.selectors)){
+                ++report.notComparable;
+                report.notComparableFeatures.push_back(entry.feature);
+                continue;
+            }
+            ++report.compared;
+            // Selectors moved above still compare against the value the user left them at.
+            const auto* original = entry.isSelector ? state.original(entry.feature) : nullptr;
+            const auto current = original ? *original : readValue(node);
+            if(!sameValue(node, current, entry.value)){
+                changed.push_back(index);
+            }
+        }
+    }catch(...){
+        state.restoreOriginals();
+        throw;
+    }
+    state.restoreOriginals();
+    report.compareTime += std::chrono::microseconds(elapsedMicroseconds(started));
+    return changed;
+}
+
+void writeConfiguration(GenApi::INodeMap& nodeMap,
+                        const ConfigurationSnapshot& snapshot,
+                        const std::vector<std::size_t>& changed,
+                        ConfigurationApplyReport& report)
+{
+    const auto started = std::chrono::steady_clock::now();
+    SelectorState state(nodeMap, report.selectorWrites);
+    const auto write = [&](const std::size_t index){
+        const auto& entry = snapshot.entries[index];
+        try{
+            auto* node = nodeMap.GetNode(entry.feature.c_str());
+            if(!node || !GenApi::IsWritable(node) || !state.select(entry.selectors)) return false;
+            if(entry.isSelector){
+                state.set(entry.feature, node, entry.value);
+            }else{
+                dynamic_cast<GenApi::IValue*>(node)->FromString(entry.value.c_str());
+            }
+            return true;
+        }catch(const GenICam::GenericException&){
+            return false;
+        }
+    };
+
+    // A write rejected because a later feature still locks it (ExposureAuto before
+    // ExposureTime, say) usually succeeds once the rest of the diff is in place.
+    const auto writeAll = [&](const bool selectors){
+        std::vector<std::size_t> retry;
+        for(const auto index : changed){
+            if(snapshot.entries[index].isSelector != selectors) continue;
+            if(write(index)){
+                ++report.written;
+            }else{
+                retry.push_back(index);
+            }
+        }
+        for(const auto index : retry){
+            if(write(index)){
+                ++report.written;
+            }else{
+                ++report.failed;
+                report.failedFeatures.push_back(snapshot.entries[index].feature);
+            }
+        }
+    };
+
+    writeAll(false);
+    // Selectors moved to reach selected features go back first; changed selector
+    // values are written last so no selected write can disturb them.
+    state.restoreOriginals();
+    writeAll(true);
+    report.writeTime += std::chrono::microseconds(elapsedMicroseconds(started));
+}
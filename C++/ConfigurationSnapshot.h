@@ -0,0 +1,85 @@
+#ifndef CONFIGURATIONSNAPSHOT_H
+#define CONFIGURATIONSNAPSHOT_H
+
+/**
+ * @file ConfigurationSnapshot.h
+ * @brief Captured feature values and diff-based restore.
+ *
+ * A snapshot lists every streamable read-write feature in feature-tree order,
+ * selected features once per reachable selector combination, and finally the
+ * selectors' own values. Applying it reads the current values first and writes
+ * only the features that differ, so restore time scales with the diff instead
+ * of the feature count.
+ */
+
+#include <pylon/PylonIncludes.h>
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct ConfigurationSnapshot
+{
+    struct Entry
+    {
+        std::string feature;
+        /** Selector values the feature was read under, outermost selector first. */
+        std::vector<std::pair<std::string, std::string>> selectors;
+        /** GenApi `ToString()` representation. */
+        std::string value;
+        /** The feature is itself a selector; its value is restored after all selected features. */
+        bool isSelector = false;
+    };
+
+    /** Entries in apply order. */
+    std::vector<Entry> entries;
+
+    [[nodiscard]] bool empty() const noexcept { return entries.empty(); }
+};
+
+struct ConfigurationApplyReport
+{
+    /** Snapshot entries compared against the camera. */
+    std::size_t compared = 0;
+    /** Entries that could not be read, or whose selectors could not be reached, and were not applied. */
+    std::size_t notComparable = 0;
+    /** Features whose value differed and were written. */
+    std::size_t written = 0;
+    std::size_t failed = 0;
+    /** Selector changes needed to reach selected features while comparing and writing. */
+    std::size_t selectorWrites = 0;
+    /** Acquisition was stopped for the writes and started again. */
+    bool grabRestarted = false;
+    std::chrono::microseconds compareTime{0};
+    std::chrono::microseconds writeTime{0};
+    std::vector<std::string> failedFeatures;
+    std::vector<std::string> notComparableFeatures;
+};
+
+/** Reads every streamable read-write feature; selectors are restored afterwards. */
+ConfigurationSnapshot captureConfiguration(GenApi::INodeMap& nodeMap);
+
+/**
+ * @brief Compares a snapshot with the current values.
+ *
+ * Only readability is required, so features that are locked while the camera
+ * is grabbing are still compared; entries that cannot be read are counted in
+ * `ConfigurationApplyReport::notComparable`.
+ * @return Indexes of the entries that differ, in apply order. Selectors are restored afterwards.
+ */
+std::vector<std::size_t> diffConfiguration(GenApi::INodeMap& nodeMap,
+                                           const ConfigurationSnapshot& snapshot,
+                                           ConfigurationApplyReport& report);
+
+/**
+ * @brief Writes the changed entries, retrying failed writes once after the others,
+ *        and leaves the selectors at their snapshot values.
+ */
+void writeConfiguration(GenApi::INodeMap& nodeMap,
+                        const ConfigurationSnapshot& snapshot,
+                        const std::vector<std::size_t>& changed,
+                        ConfigurationApplyReport& report);
+
+#endif // CONFIGURATIONSNAPSHOT_H
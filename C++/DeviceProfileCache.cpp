@@ -0,0 +1,236 @@
+#include "DeviceProfileCache.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <locale>
+#include <sstream>
+#include <system_error>
+
+namespace {
+
+constexpr const char* FileHeader = "# camera device profile cache v1";
+constexpr std::uint64_t FnvOffsetBasis = 14695981039346656037ull;
+constexpr std::uint64_t FnvPrime = 1099511628211ull;
+
+std::string sanitizeField(std::string value)
+{
+    std::replace_if(value.begin(), value.end(), [](char ch){
+        return ch == '\t' || ch == '\n' || ch == '\r' || ch == ';' || ch == '=';
+    }, ' ');
+    return value;
+}
+
+std::vector<std::string> splitFields(const std::string& line, const char separator)
+{
+    std::vector<std::string> fields;
+    std::string::size_type begin = 0;
+    while(true){
+        const auto end = line.find(separator, begin);
+        fields.push_back(line.substr(begin, end - begin));
+        if(end == std::string::npos) break;
+        begin = end + 1;
+    }
+    return fields;
+}
+
+std::string formatProfile(const DeviceProfile& profile)
+{
+    std::ostringstream out;
+    out.imbue(std::locale::classic());
+    out << std::setprecision(17);
+    const auto& scene = profile.scene3D;
+    out << sanitizeField(profile.key.serialNumber) << '\t'
+        << sanitizeField(profile.key.firmwareVersion) << '\t'
+        << std::hex << profile.key.nodeMapHash << std::dec << '\t'
+        << static_cast<int>(scene.family) << '\t'
+        << static_cast<int>(scene.geometry) << '\t'
+        << (scene.colorRegisteredToRange ? 1 : 0) << '\t'
+        << scene.coordinateScale << '\t'
+        << scene.coordinateOffset << '\t'
+        << scene.baseline << '\t'
+        << scene.focalLength << '\t'
+        << scene.principalPointU << '\t'
+        << scene.principalPointV << '\t';
+    for(std::size_t index = 0; index < profile.components.size(); ++index){
+        if(index != 0) out << ';';
+        out << sanitizeField(profile.components[index].name) << '='
+            << sanitizeField(profile.components[index].pixelFormat);
+    }
+    return out.str();
+}
+
+std::optional<DeviceProfile> parseProfile(const std::string& line)
+{
+    const auto fields = splitFields(line, '\t');
+    if(fields.size() != 13 || fields[0].empty()) return std::nullopt;
+
+    std::istringstream in;
+    in.imbue(std::locale::classic());
+    const auto parse = [&in](const std::string& text, auto& value, const bool hex = false){
+        in.clear();
+        in.str(text);
+        if(hex) in >> std::hex;
+        in >> value >> std::dec;
+        return !in.fail();
+    };
+
+    DeviceProfile profile;
+    profile.key.serialNumber = fields[0];
+    profile.key.firmwareVersion = fields[1];
+    int family = 0;
+    int geometry = 0;
+    int colorRegistered = 0;
+    auto& scene = profile.scene3D;
+    const bool parsed = parse(fields[2], profile.key.nodeMapHash, true)
+        && parse(fields[3], family)
+        && parse(fields[4], geometry)
+        && parse(fields[5], colorRegistered)
+        && parse(fields[6], scene.coordinateScale)
+        && parse(fields[7], scene.coordinateOffset)
+        && parse(fields[8], scene.baseline)
+        && parse(fields[9], scene.focalLength)
+        && parse(fields[10], scene.principalPointU)
+        && parse(fields[11], scene.principalPointV);
+    if(!parsed) return std::nullopt;
+    if(family < static_cast<int>(PylonScene3DProfile::DeviceFamily::Image2D)
+       || family > static_cast<int>(PylonScene3DProfile::DeviceFamily::StereoMini)) return std::nullopt;
+    if(geometry < static_cast<int>(PylonScene3DProfile::GeometryKind::None)
+       || geometry > static_cast<int>(PylonScene3DProfile::GeometryKind::DisparityReconstruction)) return std::nullopt;
+    scene.family = static_cast<PylonScene3DProfile::DeviceFamily>(family);
+    scene.geometry = static_cast<PylonScene3DProfile::GeometryKind>(geometry);
+    scene.colorRegisteredToRange = colorRegistered != 0;
+
+    if(!fields[12].empty()){
+        for(const auto& item : splitFields(fields[12], ';')){
+            const auto separator = item.find('=');
+            if(separator == std::string::npos) return std::nullopt;
+            profile.components.push_back({item.substr(0, separator), item.substr(separator + 1)});
+        }
+    }
+    return profile;
+}
+
+}
+
+const DeviceProfile::Component* DeviceProfile::component(const std::string& name) const
+{
+    const auto iter = std::find_if(components.begin(), components.end(), [&name](const Component& component){
+        return component.name == name;
+    });
+    return iter == components.end() ? nullptr : &*iter;
+}
+
+std::uint64_t hashNodeMap(const GenApi::INodeMap& nodeMap)
+{
+    GenApi::NodeList_t nodes;
+    nodeMap.GetNodes(nodes);
+    std::uint64_t hash = FnvOffsetBasis;
+    for(const auto* node : nodes){
+        if(!node) continue;
+        const auto name = node->GetName();
+        for(const char* ch = name.c_str(); *ch; ++ch){
+            hash = (hash ^ static_cast<unsigned char>(*ch)) * FnvPrime;
+        }
+        hash = (hash ^ 0xffu) * FnvPrime;
+    }
+    return hash;
+}
+
+DeviceProfileCache::DeviceProfileCache(std::string path)
+    : _path(std::move(path))
+{
+    load();
+}
+
+std::optional<DeviceProfile> DeviceProfileCache::find(DeviceProfileKey key) const
+{
+    // Stored keys are sanitized for the file format; compare like with like.
+    key.serialNumber = sanitizeField(std::move(key.serialNumber));
+    key.firmwareVersion = sanitizeField(std::move(key.firmwareVersion));
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto iter = std::find_if(_profiles.begin(), _profiles.end(), [&key](const DeviceProfile& profile){
+        return profile.key == key;
+    });
+    if(iter == _profiles.end()) return std::nullopt;
+    return *iter;
+}
+
+bool DeviceProfileCache::store(DeviceProfile profile)
+{
+    profile.key.serialNumber = sanitizeField(std::move(profile.key.serialNumber));
+    profile.key.firmwareVersion = sanitizeField(std::move(profile.key.firmwareVersion));
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto iter = std::find_if(_profiles.begin(), _profiles.end(), [&profile](const DeviceProfile& existing){
+        return existing.key.serialNumber == profile.key.serialNumber;
+    });
+    if(iter == _profiles.end()){
+        _profiles.push_back(std::move(profile));
+    }else{
+        *iter = std::move(profile);
+    }
+    return saveLocked();
+}
+
+bool DeviceProfileCache::erase(const std::string& rawSerialNumber)
+{
+    const auto serialNumber = sanitizeField(rawSerialNumber);
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto iter = std::remove_if(_profiles.begin(), _profiles.end(), [&serialNumber](const DeviceProfile& profile){
+        return profile.key.serialNumber == serialNumber;
+    });
+    if(iter == _profiles.end()) return false;
+    _profiles.erase(iter, _profiles.end());
+    saveLocked();
+    return true;
+}
+
+void DeviceProfileCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _profiles.clear();
+    saveLocked();
+}
+
+void DeviceProfileCache::load()
+{
+    std::ifstream file(_path);
+    if(!file) return;
+
+    std::string line;
+    if(!std::getline(file, line) || line != FileHeader) return;
+    while(std::getline(file, line)){
+        if(!line.empty() && line.back() == '\r') line.pop_back();
+        if(auto profile = parseProfile(line)){
+            _profiles.push_back(std::move(*profile));
+        }
+    }
+}
+
+bool DeviceProfileCache::saveLocked() const
+{
+    namespace fs = std::filesystem;
+    std::error_code error;
+    const fs::path target(_path);
+    if(target.has_parent_path()){
+        fs::create_directories(target.parent_path(), error);
+    }
+
+    const fs::path temporary(_path + ".tmp");
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if(!file) return false;
+        file << FileHeader << '\n';
+        for(const auto& profile : _profiles){
+            file << formatProfile(profile) << '\n';
+        }
+        if(!file.flush()) return false;
+    }
+    fs::rename(temporary, target, error);
+    if(error){
+        fs::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,89 @@
+#ifndef DEVICEPROFILECACHE_H
+#define DEVICEPROFILECACHE_H
+
+/**
+ * @file DeviceProfileCache.h
+ * @brief On-disk cache of detected device families, component layouts, and 3D profiles.
+ *
+ * Entries are keyed by serial number, firmware version, and a hash of the
+ * node map's feature names. The hash is computed from the local XML
+ * description, so validating a cache hit costs one firmware-version read
+ * instead of the selector probes of a full detection. Stereo cameras also read
+ * back the calibration values that follow the current configuration.
+ */
+
+#include "PylonScene3DProfile.h"
+
+#include <pylon/PylonIncludes.h>
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct DeviceProfileKey
+{
+    std::string serialNumber;
+    std::string firmwareVersion;
+    std::uint64_t nodeMapHash = 0;
+
+    bool operator==(const DeviceProfileKey& other) const
+    {
+        return nodeMapHash == other.nodeMapHash
+            && serialNumber == other.serialNumber
+            && firmwareVersion == other.firmwareVersion;
+    }
+};
+
+struct DeviceProfile
+{
+    /** An enabled multipart component and the pixel format it was configured with. */
+    struct Component
+    {
+        std::string name;
+        std::string pixelFormat;
+    };
+
+    DeviceProfileKey key;
+    PylonScene3DProfile scene3D;
+    std::vector<Component> components;
+
+    [[nodiscard]] const Component* component(const std::string& name) const;
+};
+
+/** FNV-1a hash over the names of all nodes; reads no device registers. */
+std::uint64_t hashNodeMap(const GenApi::INodeMap& nodeMap);
+
+/**
+ * @brief Thread-safe profile store backed by one text file.
+ *
+ * The file is read once on construction and rewritten through a temporary
+ * file on every change, so a crash never leaves a truncated cache behind.
+ * Unreadable lines are ignored.
+ */
+class DeviceProfileCache
+{
+public:
+    explicit DeviceProfileCache(std::string path);
+
+    DeviceProfileCache(const DeviceProfileCache&) = delete;
+    DeviceProfileCache& operator=(const DeviceProfileCache&) = delete;
+
+    [[nodiscard]] const std::string& path() const noexcept { return _path; }
+    [[nodiscard]] std::optional<DeviceProfile> find(DeviceProfileKey key) const;
+    /** Replaces the entry for the same serial number; `false` when the file could not be written. */
+    bool store(DeviceProfile profile);
+    bool erase(const std::string& serialNumber);
+    void clear();
+
+private:
+    void load();
+    bool saveLocked() const;
+
+    const std::string _path;
+    mutable std::mutex _mutex;
+    std::vector<DeviceProfile> _profiles;
+};
+
+#endif // DEVICEPROFILECACHE_H
@@ -0,0 +1,153 @@
+#include "DeviceTable.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace {
+
+std::string keyValue(const Pylon::CDeviceInfo& device, const DeviceKey key)
+{
+    switch(key){
+    case DeviceKey::FriendlyName:
+        return device.GetFriendlyName().c_str();
+    case DeviceKey::SerialNumber:
+        return device.IsSerialNumberAvailable() ? device.GetSerialNumber().c_str() : "";
+    case DeviceKey::UserDefinedName:
+        return device.IsUserDefinedNameAvailable() ? device.GetUserDefinedName().c_str() : "";
+    case DeviceKey::IpAddress:
+        return device.IsIpAddressAvailable() ? device.GetIpAddress().c_str() : "";
+    case DeviceKey::MacAddress:
+        return device.IsMacAddressAvailable() ? device.GetMacAddress().c_str() : "";
+    default:
+        return {};
+    }
+}
+
+bool sameIdentity(const Pylon::CDeviceInfo& before, const Pylon::CDeviceInfo& after)
+{
+    for(const auto key : {DeviceKey::FriendlyName, DeviceKey::UserDefinedName, DeviceKey::SerialNumber, DeviceKey::IpAddress}){
+        if(keyValue(before, key) != keyValue(after, key)) return false;
+    }
+    return true;
+}
+
+}
+
+bool EnumerationFilter::allows(const Pylon::CDeviceInfo& device) const
+{
+    const auto listed = [](const std::vector<std::string>& allowed, const std::string& value){
+        return std::find(allowed.begin(), allowed.end(), value) != allowed.end();
+    };
+    if(!serialNumbers.empty() && !listed(serialNumbers, keyValue(device, DeviceKey::SerialNumber))) return false;
+    if(!ipAddresses.empty() && !listed(ipAddresses, keyValue(device, DeviceKey::IpAddress))) return false;
+    return true;
+}
+
+const char* deviceClassName(const EnumerationFilter::TransportLayer transportLayer)
+{
+    // Values of pylon's Basler*DeviceClass constants.
+    switch(transportLayer){
+    case EnumerationFilter::TransportLayer::GigE:
+        return "BaslerGigE";
+    case EnumerationFilter::TransportLayer::Usb:
+        return "BaslerUsb";
+    case EnumerationFilter::TransportLayer::CoaXPress:
+        return "BaslerGenTlCxp";
+    case EnumerationFilter::TransportLayer::CameraEmulation:
+        return "BaslerCamEmu";
+    }
+    return "";
+}
+
+DeviceTable::DeviceTable(Pylon::DeviceInfoList_t devices, const Clock::time_point enumeratedAt)
+    : _devices(std::move(devices))
+    , _enumerated(true)
+    , _enumeratedAt(enumeratedAt)
+{
+    for(std::size_t key = 0; key < _indexes.size(); ++key){
+        auto& index = _indexes[key];
+        index.reserve(_devices.size());
+        for(std::size_t position = 0; position < _devices.size(); ++position){
+            auto value = normalize(static_cast<DeviceKey>(key), keyValue(_devices[position], static_cast<DeviceKey>(key)));
+            if(!value.empty()){
+                index.emplace(std::move(value), position);
+            }
+        }
+    }
+}
+
+const Pylon::CDeviceInfo* DeviceTable::find(const DeviceKey key, const std::string& value) const
+{
+    const auto position = static_cast<std::size_t>(key);
+    if(position >= _indexes.size() || value.empty()) return nullptr;
+    const auto& index = _indexes[position];
+    const auto iter = index.find(key == DeviceKey::MacAddress ? normalize(key, value) : value);
+    return iter == index.end() ? nullptr : &_devices[iter->second];
+}
+
+const Pylon::CDeviceInfo* DeviceTable::find(const std::string& value) const
+{
+    for(std::size_t key = 0; key < _indexes.size(); ++key){
+        if(const auto* device = find(static_cast<DeviceKey>(key), value)) return device;
+    }
+    return nullptr;
+}
+
+std::vector<std::string> DeviceTable::friendlyNames() const
+{
+    std::vector<std::string> names;
+    names.reserve(_devices.size());
+    for(const auto& device : _devices){
+        names.emplace_back(device.GetFriendlyName().c_str());
+    }
+    return names;
+}
+
+DeviceTable::Clock::duration DeviceTable::age() const
+{
+    if(!_enumerated) return Clock::duration::max();
+    return Clock::now() - _enumeratedAt;
+}
+
+std::string DeviceTable::normalize(const DeviceKey key, std::string value)
+{
+    if(key != DeviceKey::MacAddress) return value;
+    value.erase(std::remove_if(value.begin(), value.end(), [](const unsigned char c){
+        return c == ':' || c == '-' || c == '.';
+    }), value.end());
+    std::transform(value.begin(), value.end(), value.begin(), [](const unsigned char c){
+        return static_cast<char>(std::toupper(c));
+    });
+    return value;
+}
+
+DeviceListDiff diffDeviceTables(const DeviceTable& before, std::shared_ptr<const DeviceTable> after)
+{
+    DeviceListDiff diff;
+    diff.table = std::move(after);
+    if(!diff.table) return diff;
+
+    std::unordered_map<std::string, const Pylon::CDeviceInfo*> previous;
+    previous.reserve(before.devices().size());
+    for(const auto& device : before.devices()){
+        previous.emplace(device.GetFullName().c_str(), &device);
+    }
+    for(const auto& device : diff.table->devices()){
+        const auto iter = previous.find(device.GetFullName().c_str());
+        if(iter == previous.end()){
+            diff.added.push_back(device);
+            continue;
+        }
+        if(!sameIdentity(*iter->second, device)){
+            diff.changed.push_back(device);
+        }
+        previous.erase(iter);
+    }
+    // Keep the removed devices in their previous enumeration order.
+    for(const auto& device : before.devices()){
+        if(previous.count(device.GetFullName().c_str())){
+            diff.removed.push_back(device);
+        }
+    }
+    return diff;
+}
@@ -0,0 +1,109 @@
+#ifndef DEVICETABLE_H
+#define DEVICETABLE_H
+
+/**
+ * @file DeviceTable.h
+ * @brief Immutable result of one device enumeration, indexed for constant-time lookups.
+ *
+ * A table is built once per enumeration and never changes afterwards, so
+ * lookups can run on a shared copy without holding the system lock while
+ * another thread enumerates.
+ */
+
+#include <pylon/PylonIncludes.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+enum class DeviceKey : std::size_t
+{
+    FriendlyName,
+    SerialNumber,
+    UserDefinedName,
+    IpAddress,
+    /** Compared without separators and case, e.g. `00:30:53:1A:2B:3C` matches `0030531a2b3c`. */
+    MacAddress,
+    Count
+};
+
+/** Restricts which devices an enumeration reports. */
+struct EnumerationFilter
+{
+    enum class TransportLayer
+    {
+        GigE,
+        Usb,
+        CoaXPress,
+        CameraEmulation
+    };
+
+    /**
+     * Enumerated in parallel, and results are merged in this order. Only these
+     * transport layers are loaded. Empty enumerates every installed transport
+     * layer through `CTlFactory`.
+     */
+    std::vector<TransportLayer> transportLayers;
+    /** When not empty, only devices with one of these serial numbers are reported. */
+    std::vector<std::string> serialNumbers;
+    /** When not empty, only devices with one of these IP addresses are reported; USB devices never match. */
+    std::vector<std::string> ipAddresses;
+
+    /** `true` when `device` passes both allow-lists. */
+    [[nodiscard]] bool allows(const Pylon::CDeviceInfo& device) const;
+};
+
+/** pylon device class of a transport layer, e.g. `BaslerGigE`. */
+const char* deviceClassName(EnumerationFilter::TransportLayer transportLayer);
+
+class DeviceTable
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /** Empty table that was never enumerated. */
+    DeviceTable() = default;
+    DeviceTable(Pylon::DeviceInfoList_t devices, Clock::time_point enumeratedAt);
+
+    /** @return Null when no device has `value` for `key`; the first device wins on duplicates. */
+    [[nodiscard]] const Pylon::CDeviceInfo* find(DeviceKey key, const std::string& value) const;
+    /** Tries every key in `DeviceKey` order. */
+    [[nodiscard]] const Pylon::CDeviceInfo* find(const std::string& value) const;
+
+    /** Devices in enumeration order. */
+    [[nodiscard]] const Pylon::DeviceInfoList_t& devices() const noexcept { return _devices; }
+    [[nodiscard]] std::vector<std::string> friendlyNames() const;
+    [[nodiscard]] bool isEnumerated() const noexcept { return _enumerated; }
+    [[nodiscard]] Clock::time_point enumeratedAt() const noexcept { return _enumeratedAt; }
+    /** Time since enumeration; `Clock::duration::max()` for a table that was never enumerated. */
+    [[nodiscard]] Clock::duration age() const;
+
+private:
+    static std::string normalize(DeviceKey key, std::string value);
+
+    Pylon::DeviceInfoList_t _devices;
+    std::array<std::unordered_map<std::string, std::size_t>, static_cast<std::size_t>(DeviceKey::Count)> _indexes;
+    bool _enumerated = false;
+    Clock::time_point _enumeratedAt;
+};
+
+/** Difference between two enumerations; devices are matched by their transport-layer full name. */
+struct DeviceListDiff
+{
+    std::vector<Pylon::CDeviceInfo> added;
+    std::vector<Pylon::CDeviceInfo> removed;
+    /** New info of devices whose friendly name, user-defined name, serial number, or IP address changed. */
+    std::vector<Pylon::CDeviceInfo> changed;
+    /** Table after the enumeration. */
+    std::shared_ptr<const DeviceTable> table;
+
+    [[nodiscard]] bool empty() const noexcept { return added.empty() && removed.empty() && changed.empty(); }
+};
+
+DeviceListDiff diffDeviceTables(const DeviceTable& before, std::shared_ptr<const DeviceTable> after);
+
+#endif // DEVICETABLE_H
@@ -0,0 +1,146 @@
+#include "FrameArena.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#ifdef _WIN32
+#include <malloc.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+void* allocatePageAligned(const std::size_t alignment, const std::size_t size)
+{
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    void* memory = nullptr;
+    return posix_memalign(&memory, alignment, size) == 0 ? memory : nullptr;
+#endif
+}
+
+void freePageAligned(void* memory)
+{
+#ifdef _WIN32
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+// Writes one byte per page so the first burst does not take a page fault inside
+// its memcpy; allocators hand out large blocks as untouched, lazily mapped pages.
+void prefaultPages(std::uint8_t* storage, const std::size_t size, const std::size_t page)
+{
+    for(std::size_t offset = 0; offset < size; offset += page){
+        static_cast<volatile std::uint8_t*>(storage)[offset] = 0;
+    }
+}
+
+std::size_t roundUp(const std::size_t value, const std::size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+}
+
+FrameArena::FrameArena(const std::size_t frameCapacity, const std::size_t frameBytes)
+{
+    reserve(frameCapacity, frameBytes);
+}
+
+FrameArena::~FrameArena()
+{
+    release();
+}
+
+FrameArena::FrameArena(FrameArena&& other) noexcept
+    : _storage(std::exchange(other._storage, nullptr))
+    , _frameCapacity(std::exchange(other._frameCapacity, 0))
+    , _slotSize(std::exchange(other._slotSize, 0))
+    , _frames(std::move(other._frames))
+{
+}
+
+FrameArena& FrameArena::operator=(FrameArena&& other) noexcept
+{
+    if(this != &other){
+        release();
+        _storage = std::exchange(other._storage, nullptr);
+        _frameCapacity = std::exchange(other._frameCapacity, 0);
+        _slotSize = std::exchange(other._slotSize, 0);
+        _frames = std::move(other._frames);
+    }
+    return *this;
+}
+
+bool FrameArena::reserve(const std::size_t frameCapacity, const std::size_t frameBytes)
+{
+    clear();
+    if(frameCapacity == 0 || frameBytes == 0) return false;
+
+    const auto page = pageSize();
+    const auto slotSize = roundUp(frameBytes, page);
+    if(_storage && frameCapacity <= _frameCapacity && slotSize <= _slotSize){
+        _frames.reserve(frameCapacity);
+        return true;
+    }
+    if(frameCapacity > std::numeric_limits<std::size_t>::max() / slotSize) return false;
+
+    auto* storage = static_cast<std::uint8_t*>(allocatePageAligned(page, frameCapacity * slotSize));
+    if(!storage) return false;
+    prefaultPages(storage, frameCapacity * slotSize, page);
+
+    release();
+    _storage = storage;
+    _frameCapacity = frameCapacity;
+    _slotSize = slotSize;
+    _frames.reserve(frameCapacity);
+    return true;
+}
+
+void FrameArena::clear() noexcept
+{
+    _frames.clear();
+}
+
+bool FrameArena::append(const void* data, const std::size_t size, BurstFrameInfo info)
+{
+    if(_frames.size() >= _frameCapacity || size > _slotSize || (!data && size != 0)) return false;
+
+    info.offset = _frames.size() * _slotSize;
+    info.size = size;
+    if(size != 0){
+        std::memcpy(_storage + info.offset, data, size);
+    }
+    _frames.push_back(info);
+    return true;
+}
+
+std::size_t FrameArena::pageSize()
+{
+#ifdef _WIN32
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    return systemInfo.dwPageSize;
+#else
+    const auto page = sysconf(_SC_PAGESIZE);
+    return page > 0 ? static_cast<std::size_t>(page) : 4096;
+#endif
+}
+
+void FrameArena::release() noexcept
+{
+    if(_storage){
+        freePageAligned(_storage);
+    }
+    _storage = nullptr;
+    _frameCapacity = 0;
+    _slotSize = 0;
+    _frames.clear();
+}
@@ -0,0 +1,91 @@
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+/**
+ * @file FrameArena.h
+ * @brief Preallocated, page-aligned contiguous storage for burst captures.
+ *
+ * Frames land in fixed-stride, page-aligned slots of one allocation, and the
+ * per-frame metadata array is reserved up front, so a burst performs no heap
+ * allocation and the batch can be processed with a linear memory walk.
+ */
+
+#include "FrameHandle.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct BurstFrameInfo
+{
+    std::size_t sequence = 0;
+    std::uint64_t blockId = 0;
+    /** Device timestamp in camera ticks. */
+    std::uint64_t deviceTimestamp = 0;
+    /** Host steady-clock time in nanoseconds when the result was retrieved. */
+    std::int64_t hostTimestampNs = 0;
+    std::size_t offset = 0;
+    std::size_t size = 0;
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    Pylon::EPixelType pixelType = Pylon::PixelType_Undefined;
+};
+
+class FrameArena
+{
+public:
+    FrameArena() = default;
+    /** Reserves storage for `frameCapacity` frames of up to `frameBytes` each. */
+    FrameArena(std::size_t frameCapacity, std::size_t frameBytes);
+    ~FrameArena();
+
+    FrameArena(FrameArena&& other) noexcept;
+    FrameArena& operator=(FrameArena&& other) noexcept;
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /**
+     * @brief Ensures room for `frameCapacity` frames of up to `frameBytes` each.
+     * @return `false` when the allocation fails; existing storage is kept when large enough.
+     * @note Clears previously captured frames. New storage is touched page by page here,
+     *       so the burst does not pay for page faults.
+     */
+    bool reserve(std::size_t frameCapacity, std::size_t frameBytes);
+    /** Forgets captured frames while keeping the storage. */
+    void clear() noexcept;
+
+    /**
+     * @brief Copies one frame into the next slot.
+     * @return `false` when the arena is full or the frame exceeds the slot size.
+     */
+    bool append(const void* data, std::size_t size, BurstFrameInfo info);
+
+    [[nodiscard]] std::size_t frameCapacity() const noexcept { return _frameCapacity; }
+    [[nodiscard]] std::size_t slotSize() const noexcept { return _slotSize; }
+    [[nodiscard]] std::size_t frameCount() const noexcept { return _frames.size(); }
+    [[nodiscard]] const std::uint8_t* data() const noexcept { return _storage; }
+    [[nodiscard]] std::size_t sizeBytes() const noexcept { return _frameCapacity * _slotSize; }
+
+    [[nodiscard]] const BurstFrameInfo& frameInfo(std::size_t index) const { return _frames.at(index); }
+    [[nodiscard]] const std::vector<BurstFrameInfo>& frames() const noexcept { return _frames; }
+    /** Payload of frame `index` as elements of `T`. */
+    template<typename T>
+    [[nodiscard]] FrameSpan<const T> frame(const std::size_t index) const
+    {
+        const auto& info = _frames.at(index);
+        return {reinterpret_cast<const T*>(_storage + info.offset), info.size / sizeof(T)};
+    }
+
+    /** System page size used for slot alignment. */
+    static std::size_t pageSize();
+
+private:
+    void release() noexcept;
+
+    std::uint8_t* _storage = nullptr;
+    std::size_t _frameCapacity = 0;
+    std::size_t _slotSize = 0;
+    std::vector<BurstFrameInfo> _frames;
+};
+
+#endif // FRAMEARENA_H
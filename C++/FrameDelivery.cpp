@@ -0,0 +1,149 @@
+#include "FrameDelivery.h"
+#include "CameraSystem.h"
+
+#include <algorithm>
+#include <exception>
+
+std::shared_ptr<FrameDeliveryQueue> FrameDeliveryQueue::start(Handler handler,
+                                                             const FrameDeliveryOptions& options,
+                                                             const ThreadSettings& thread,
+                                                             const std::string& defaultThreadName)
+{
+    std::shared_ptr<FrameDeliveryQueue> queue(new FrameDeliveryQueue(std::move(handler), options));
+    queue->_thread = std::thread([self = queue, thread, defaultThreadName]{
+        const auto report = applyCurrentThreadSettings(thread, defaultThreadName);
+        for(const auto& error : report.errors){
+            CameraSystem::syslog("[WARN] Delivery thread " + report.name + ": " + error, true);
+        }
+        self->run();
+    });
+    return queue;
+}
+
+FrameDeliveryQueue::FrameDeliveryQueue(Handler handler, const FrameDeliveryOptions& options)
+    : _handler(std::move(handler))
+    , _options(options)
+{
+    const auto capacity = options.policy == FrameDeliveryOptions::Policy::LatestOnly
+        ? std::size_t(1)
+        : std::max<std::size_t>(1, options.queueDepth);
+    _slots.resize(capacity);
+    _statistics.capacity = capacity;
+}
+
+FrameDeliveryQueue::~FrameDeliveryQueue()
+{
+    if(_thread.joinable()){
+        _thread.detach();
+    }
+}
+
+void FrameDeliveryQueue::push(const FrameHandle& frame, const std::atomic<bool>& producerRunning)
+{
+    FrameHandle evicted;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if(_stopping) return;
+
+        const auto offered = _statistics.offered++;
+        if(_options.policy == FrameDeliveryOptions::Policy::Decimate
+           && offered % std::max<std::size_t>(1, _options.decimation) != 0){
+            ++_statistics.decimated;
+            return;
+        }
+
+        if(_count == _slots.size()){
+            if(_options.policy == FrameDeliveryOptions::Policy::Block){
+                _spaceAvailable.wait(lock, [this, &producerRunning]{
+                    return _stopping
+                        || _count < _slots.size()
+                        || !producerRunning.load(std::memory_order_acquire);
+                });
+                if(_stopping || _count == _slots.size()){
+                    ++_statistics.dropped;
+                    return;
+                }
+            }else{
+                evicted = std::move(_slots[_head]);
+                _head = (_head + 1) % _slots.size();
+                --_count;
+                ++_statistics.dropped;
+            }
+        }
+
+        _slots[(_head + _count) % _slots.size()] = frame;
+        ++_count;
+        _statistics.depth = _count;
+    }
+    _frameAvailable.notify_one();
+}
+
+void FrameDeliveryQueue::wakeProducer()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+    }
+    _spaceAvailable.notify_all();
+}
+
+void FrameDeliveryQueue::stop()
+{
+    std::vector<FrameHandle> pending;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if(_stopping && !_thread.joinable()) return;
+        _stopping = true;
+        _statistics.dropped += _count;
+        pending.swap(_slots);
+        _slots.resize(pending.size());
+        _head = 0;
+        _count = 0;
+        _statistics.depth = 0;
+    }
+    _frameAvailable.notify_all();
+    _spaceAvailable.notify_all();
+
+    if(!_thread.joinable()) return;
+    if(_thread.get_id() == std::this_thread::get_id()){
+        _thread.detach();
+    }else{
+        _thread.join();
+    }
+}
+
+FrameDeliveryStatistics FrameDeliveryQueue::statistics() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _statistics;
+}
+
+void FrameDeliveryQueue::run()
+{
+    while(true){
+        FrameHandle frame;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _frameAvailable.wait(lock, [this]{ return _stopping || _count > 0; });
+            if(_stopping) break;
+
+            frame = std::move(_slots[_head]);
+            _head = (_head + 1) % _slots.size();
+            --_count;
+            _statistics.depth = _count;
+        }
+        _spaceAvailable.notify_one();
+
+        try{
+            _handler(frame);
+        }catch(const GenericException &e){
+            CameraSystem::syslog(std::string("[WARN] Frame delivery handler exception: ") + e.GetDescription(), true);
+        }catch(const std::exception &e){
+            CameraSystem::syslog(std::string("[WARN] Frame delivery handler exception: ") + e.what(), true);
+        }catch(...){
+            CameraSystem::syslog("[WARN] Frame delivery handler unknown exception", true);
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_statistics.delivered;
+    }
+}
@@ -0,0 +1,112 @@
+#ifndef FRAMEDELIVERY_H
+#define FRAMEDELIVERY_H
+
+/**
+ * @file FrameDelivery.h
+ * @brief Bounded per-subscriber frame queue with its own executor thread.
+ *
+ * Lets one grab subscriber consume frames at its own pace without stalling the
+ * Camera worker or other subscribers. Frames are queued as FrameHandle copies,
+ * so queued frames hold their stream buffers until they are delivered or dropped.
+ */
+
+#include "FrameHandle.h"
+#include "ThreadSettings.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct FrameDeliveryOptions
+{
+    enum class Policy
+    {
+        /** Blocks the Camera worker while the queue is full. */
+        Block,
+        /** Discards the oldest queued frame to make room. */
+        DropOldest,
+        /** Keeps only the newest frame; the queue depth is forced to one. */
+        LatestOnly,
+        /** Queues every `decimation`-th frame and drops the oldest when full. */
+        Decimate
+    };
+
+    Policy policy = Policy::DropOldest;
+    std::size_t queueDepth = 4;
+    std::size_t decimation = 1;
+};
+
+struct FrameDeliveryStatistics
+{
+    std::size_t depth = 0;
+    std::size_t capacity = 0;
+    std::uint64_t offered = 0;
+    std::uint64_t delivered = 0;
+    /** Frames discarded because the queue was full or the subscriber stopped. */
+    std::uint64_t dropped = 0;
+    /** Frames skipped by the `Decimate` policy. */
+    std::uint64_t decimated = 0;
+};
+
+class FrameDeliveryQueue
+{
+public:
+    using Handler = std::function<void(const FrameHandle& frame)>;
+
+    /**
+     * @brief Creates the queue and starts its executor thread.
+     * @param thread Executor thread settings; `defaultThreadName` is used when it has no name.
+     */
+    static std::shared_ptr<FrameDeliveryQueue> start(Handler handler,
+                                                     const FrameDeliveryOptions& options,
+                                                     const ThreadSettings& thread = {},
+                                                     const std::string& defaultThreadName = {});
+    ~FrameDeliveryQueue();
+
+    FrameDeliveryQueue(const FrameDeliveryQueue&) = delete;
+    FrameDeliveryQueue& operator=(const FrameDeliveryQueue&) = delete;
+
+    /**
+     * @brief Offers one frame according to the delivery policy.
+     * @param producerRunning Cleared by the producer to abandon a blocked push.
+     */
+    void push(const FrameHandle& frame, const std::atomic<bool>& producerRunning);
+    /** Wakes a producer blocked in `push()` so it can re-check `producerRunning`. */
+    void wakeProducer();
+    /**
+     * @brief Stops the executor and drops queued frames.
+     * @note When called from the executor thread itself the thread is detached and
+     *       exits after the current handler returns.
+     */
+    void stop();
+
+    [[nodiscard]] FrameDeliveryStatistics statistics() const;
+    [[nodiscard]] FrameDeliveryOptions::Policy policy() const noexcept { return _options.policy; }
+
+private:
+    FrameDeliveryQueue(Handler handler, const FrameDeliveryOptions& options);
+    void run();
+
+    const Handler _handler;
+    const FrameDeliveryOptions _options;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _frameAvailable;
+    std::condition_variable _spaceAvailable;
+    std::vector<FrameHandle> _slots;
+    std::size_t _head = 0;
+    std::size_t _count = 0;
+    bool _stopping = false;
+    FrameDeliveryStatistics _statistics;
+
+    std::thread _thread;
+};
+
+#endif // FRAMEDELIVERY_H
@@ -0,0 +1,210 @@
+#include "FrameHandle.h"
+#include "TraceRecorder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+struct FrameHandle::Storage
+{
+    // Written by the dispatching thread while consumers may already read the
+    // frame, so every mutable field is atomic. A callback slot is published by
+    // storing its non-zero end time last.
+    struct CallbackSlot
+    {
+        std::atomic<FrameTiming::CallbackSource> source{FrameTiming::CallbackSource::Grab};
+        std::atomic<std::size_t> callbackId{0};
+        std::atomic<std::int64_t> endNs{0};
+    };
+
+
+    Pylon::CGrabResultPtr grabResult;
+    Pylon::CPylonImage image;
+    Pylon::CPylonDataContainer container;
+    std::vector<FrameComponent> components;
+    const void* bufferData = nullptr;
+    std::size_t bufferSize = 0;
+    std::size_t sequence = 0;
+    bool multiPart = false;
+
+    std::uint64_t deviceTimestamp = 0;
+    std::int64_t hostReceiveNs = 0;
+    std::int64_t creditWaitNs = 0;
+    ChunkMetadata chunks;
+    mutable std::atomic<std::int64_t> dispatchStartNs{0};
+    mutable std::atomic<std::int64_t> dispatchEndNs{0};
+    mutable std::atomic<std::size_t> callbackEndCount{0};
+    mutable std::array<CallbackSlot, FrameTiming::MaxCallbackEnds> callbackEnds;
+};
+
+namespace {
+
+// Function-local so no SDK object is constructed before PylonInitialize().
+const Pylon::CGrabResultPtr& emptyGrabResult()
+{
+    static const Pylon::CGrabResultPtr value;
+    return value;
+}
+
+const Pylon::CPylonImage& emptyImage()
+{
+    static const Pylon::CPylonImage value;
+    return value;
+}
+
+const Pylon::CPylonDataContainer& emptyContainer()
+{
+    static const Pylon::CPylonDataContainer value;
+    return value;
+}
+
+const FrameComponent emptyComponent;
+const ChunkMetadata emptyChunks;
+
+}
+
+std::int64_t FrameTiming::now() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+FrameHandle::FrameHandle(const Pylon::CGrabResultPtr& grabResult,
+                         const std::size_t sequence,
+                         const bool multiPart,
+                         const std::int64_t hostReceiveNs,
+                         const std::int64_t creditWaitNs,
+                         const ChunkMetadata& chunks)
+{
+    auto storage = std::make_shared<Storage>();
+    storage->grabResult = grabResult;
+    storage->sequence = sequence;
+    storage->multiPart = multiPart;
+    storage->deviceTimestamp = grabResult->GetTimeStamp();
+    storage->hostReceiveNs = hostReceiveNs;
+    storage->creditWaitNs = creditWaitNs;
+    storage->chunks = chunks;
+
+    if(multiPart){
+        CAMERA_TRACE_SCOPE_ARG("GetDataContainer", "frame", sequence);
+        storage->container = grabResult->GetDataContainer();
+        const auto count = storage->container.GetDataComponentCount();
+        storage->components.reserve(count);
+        for(std::size_t index = 0; index < count; ++index){
+            const auto component = storage->container.GetDataComponent(index);
+            FrameComponent descriptor;
+            if(component.IsValid()){
+                descriptor.type = component.GetComponentType();
+                descriptor.pixelType = component.GetPixelType();
+                descriptor.width = component.GetWidth();
+                descriptor.height = component.GetHeight();
+                descriptor.data = component.GetData();
+                descriptor.size = component.GetDataSize();
+            }
+            storage->components.push_back(descriptor);
+        }
+    }else{
+        storage->image.AttachGrabResultBuffer(grabResult);
+        storage->bufferData = grabResult->GetBuffer();
+        storage->bufferSize = grabResult->GetImageSize();
+    }
+
+    _storage = std::move(storage);
+}
+
+std::size_t FrameHandle::sequence() const noexcept
+{
+    return _storage ? _storage->sequence : 0;
+}
+
+bool FrameHandle::isMultiPart() const noexcept
+{
+    return _storage && _storage->multiPart;
+}
+
+const Pylon::CGrabResultPtr& FrameHandle::grabResult() const
+{
+    return _storage ? _storage->grabResult : emptyGrabResult();
+}
+
+const Pylon::CPylonImage& FrameHandle::image() const
+{
+    return _storage ? _storage->image : emptyImage();
+}
+
+const Pylon::CPylonDataContainer& FrameHandle::dataContainer() const
+{
+    return _storage ? _storage->container : emptyContainer();
+}
+
+const void* FrameHandle::bufferData() const noexcept
+{
+    return _storage ? _storage->bufferData : nullptr;
+}
+
+std::size_t FrameHandle::bufferSize() const noexcept
+{
+    return _storage ? _storage->bufferSize : 0;
+}
+
+std::size_t FrameHandle::componentCount() const noexcept
+{
+    return _storage ? _storage->components.size() : 0;
+}
+
+const FrameComponent& FrameHandle::component(const std::size_t index) const noexcept
+{
+    if(!_storage || index >= _storage->components.size()) return emptyComponent;
+    return _storage->components[index];
+}
+
+const ChunkMetadata& FrameHandle::chunkMetadata() const noexcept
+{
+    return _storage ? _storage->chunks : emptyChunks;
+}
+
+FrameTiming FrameHandle::timing() const noexcept
+{
+    FrameTiming timing;
+    if(!_storage) return timing;
+
+    timing.deviceTimestamp = _storage->deviceTimestamp;
+    timing.hostReceiveNs = _storage->hostReceiveNs;
+    timing.creditWaitNs = _storage->creditWaitNs;
+    timing.dispatchStartNs = _storage->dispatchStartNs.load(std::memory_order_acquire);
+    timing.dispatchEndNs = _storage->dispatchEndNs.load(std::memory_order_acquire);
+
+    const auto count = std::min(_storage->callbackEndCount.load(std::memory_order_acquire),
+                                FrameTiming::MaxCallbackEnds);
+    for(std::size_t index = 0; index < count; ++index){
+        const auto& slot = _storage->callbackEnds[index];
+        const auto endNs = slot.endNs.load(std::memory_order_acquire);
+        if(endNs == 0) continue;
+        timing.callbackEnds[timing.callbackEndCount++] = {slot.source.load(std::memory_order_relaxed),
+                                                          slot.callbackId.load(std::memory_order_relaxed), endNs};
+    }
+    return timing;
+}
+
+void FrameHandle::recordDispatchStart(const std::int64_t timeNs) const noexcept
+{
+    if(_storage) _storage->dispatchStartNs.store(timeNs, std::memory_order_release);
+}
+
+void FrameHandle::recordCallbackEnd(const FrameTiming::CallbackSource source, const std::size_t callbackId,
+                                    const std::int64_t timeNs) const noexcept
+{
+    if(!_storage) return;
+
+    const auto index = _storage->callbackEndCount.fetch_add(1, std::memory_order_acq_rel);
+    if(index >= FrameTiming::MaxCallbackEnds) return;
+    auto& slot = _storage->callbackEnds[index];
+    slot.source.store(source, std::memory_order_relaxed);
+    slot.callbackId.store(callbackId, std::memory_order_relaxed);
+    slot.endNs.store(timeNs, std::memory_order_release);
+}
+
+void FrameHandle::recordDispatchEnd(const std::int64_t timeNs) const noexcept
+{
+    if(_storage) _storage->dispatchEndNs.store(timeNs, std::memory_order_release);
+}
@@ -0,0 +1,174 @@
+#ifndef FRAMEHANDLE_H
+#define FRAMEHANDLE_H
+
+/**
+ * @file FrameHandle.h
+ * @brief Reference-counted, zero-copy ownership of one pylon grab result.
+ *
+ * A FrameHandle keeps the SDK grab buffer out of the stream pool until the last
+ * copy is released, so consumers can retain 2D and multipart frames past the
+ * grab callback without copying pixel data.
+ */
+
+#include "ChunkMetadata.h"
+
+#include <pylon/PylonIncludes.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Non-owning typed view over a contiguous frame buffer.
+ *
+ * Valid only while a FrameHandle referencing the same grab result is alive.
+ */
+template<typename T>
+class FrameSpan
+{
+public:
+    FrameSpan() = default;
+    FrameSpan(T* data, std::size_t size) noexcept : _data(data), _size(data ? size : 0) {}
+
+    [[nodiscard]] T* data() const noexcept { return _data; }
+    [[nodiscard]] std::size_t size() const noexcept { return _size; }
+    [[nodiscard]] std::size_t sizeBytes() const noexcept { return _size * sizeof(T); }
+    [[nodiscard]] bool empty() const noexcept { return _size == 0; }
+    [[nodiscard]] T* begin() const noexcept { return _data; }
+    [[nodiscard]] T* end() const noexcept { return _data + _size; }
+    T& operator[](std::size_t index) const noexcept { return _data[index]; }
+
+private:
+    T* _data = nullptr;
+    std::size_t _size = 0;
+};
+
+/** Describes one component of a multipart grab result. */
+struct FrameComponent
+{
+    Pylon::EComponentType type = Pylon::ComponentType_Undefined;
+    Pylon::EPixelType pixelType = Pylon::PixelType_Undefined;
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    const void* data = nullptr;
+    std::size_t size = 0;
+
+    /** Reinterprets the component payload as elements of `T`. */
+    template<typename T>
+    [[nodiscard]] FrameSpan<const T> as() const noexcept
+    {
+        return {static_cast<const T*>(data), size / sizeof(T)};
+    }
+};
+
+/**
+ * @brief Per-frame latency record; host times are steady-clock nanoseconds.
+ *
+ * Host times share the `FrameTiming::now()` time base and can be subtracted
+ * directly. The device timestamp is in camera ticks and is not converted.
+ */
+struct FrameTiming
+{
+    /** Number of callback completions retained per frame; later ones are dropped. */
+    static constexpr std::size_t MaxCallbackEnds = 16;
+
+    /** Registry a callback was registered with; each numbers its callbacks from 1. */
+    enum class CallbackSource : std::uint8_t
+    {
+        Grab,
+        Grab3D,
+        Frame
+    };
+
+    struct CallbackEnd
+    {
+        CallbackSource source = CallbackSource::Grab;
+        /** Id returned by the registering call for `source`. */
+        std::size_t callbackId = 0;
+        std::int64_t endNs = 0;
+    };
+
+    std::uint64_t deviceTimestamp = 0;
+    /** Time `RetrieveResult` returned the frame. */
+    std::int64_t hostReceiveNs = 0;
+    /** Time the worker waited for a free-run credit before dispatching. */
+    std::int64_t creditWaitNs = 0;
+    std::int64_t dispatchStartNs = 0;
+    /** Time the last synchronous callback returned; zero while dispatch is in progress. */
+    std::int64_t dispatchEndNs = 0;
+    /**
+     * Return time of each synchronous callback in dispatch order. For queued
+     * subscribers this is the time the frame was handed to the queue.
+     */
+    std::array<CallbackEnd, MaxCallbackEnds> callbackEnds{};
+    std::size_t callbackEndCount = 0;
+
+    /** Current steady-clock time in nanoseconds. */
+    static std::int64_t now() noexcept;
+};
+
+class FrameHandle
+{
+public:
+    FrameHandle() = default;
+    /**
+     * @brief Takes shared ownership of one successful grab result.
+     * @param grabResult Grab result retrieved from the instant camera.
+     * @param sequence Camera-local delivery sequence number.
+     * @param multiPart `true` to resolve the multipart data container and its components.
+     * @throws Pylon::GenericException when the multipart container cannot be resolved.
+     */
+    FrameHandle(const Pylon::CGrabResultPtr& grabResult,
+                std::size_t sequence,
+                bool multiPart,
+                std::int64_t hostReceiveNs = 0,
+                std::int64_t creditWaitNs = 0,
+                const ChunkMetadata& chunks = {});
+
+    [[nodiscard]] bool isValid() const noexcept { return static_cast<bool>(_storage); }
+    explicit operator bool() const noexcept { return isValid(); }
+
+    [[nodiscard]] std::size_t sequence() const noexcept;
+    [[nodiscard]] bool isMultiPart() const noexcept;
+    /** Number of handles, including this one, sharing the grab result. */
+    [[nodiscard]] long useCount() const noexcept { return _storage.use_count(); }
+    /** Drops this reference; the buffer returns to the pool with the last one. */
+    void reset() noexcept { _storage.reset(); }
+
+    [[nodiscard]] const Pylon::CGrabResultPtr& grabResult() const;
+    /** SDK image attached to the grab buffer; invalid for multipart frames. */
+    [[nodiscard]] const Pylon::CPylonImage& image() const;
+    /** Multipart data container; empty for 2D frames. */
+    [[nodiscard]] const Pylon::CPylonDataContainer& dataContainer() const;
+
+    /** 2D image payload as elements of `T`; empty for multipart frames. */
+    template<typename T>
+    [[nodiscard]] FrameSpan<const T> buffer() const noexcept
+    {
+        return {static_cast<const T*>(bufferData()), bufferSize() / sizeof(T)};
+    }
+    [[nodiscard]] const void* bufferData() const noexcept;
+    [[nodiscard]] std::size_t bufferSize() const noexcept;
+
+    [[nodiscard]] std::size_t componentCount() const noexcept;
+    /** Component at `index`; an empty descriptor when out of range. */
+    [[nodiscard]] const FrameComponent& component(std::size_t index) const noexcept;
+
+    /** Chunk values parsed on the acquisition thread; all `has*` flags are false without chunk mode. */
+    [[nodiscard]] const ChunkMetadata& chunkMetadata() const noexcept;
+
+    /** Snapshot of the frame's timing record; safe to call while dispatch is in progress. */
+    [[nodiscard]] FrameTiming timing() const noexcept;
+    /** Producer-side updates; shared by every handle referencing this frame. */
+    void recordDispatchStart(std::int64_t timeNs) const noexcept;
+    void recordCallbackEnd(FrameTiming::CallbackSource source, std::size_t callbackId, std::int64_t timeNs) const noexcept;
+    void recordDispatchEnd(std::int64_t timeNs) const noexcept;
+
+private:
+    struct Storage;
+    std::shared_ptr<const Storage> _storage;
+};
+
+#endif // FRAMEHANDLE_H
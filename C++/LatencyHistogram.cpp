@@ -0,0 +1,98 @@
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+unsigned mostSignificantBit(const std::uint64_t value) noexcept
+{
+#ifdef _MSC_VER
+    unsigned long index = 0;
+    _BitScanReverse64(&index, value);
+    return static_cast<unsigned>(index);
+#else
+    return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#endif
+}
+
+}
+
+void LatencyHistogram::record(const std::int64_t value) noexcept
+{
+    const auto clamped = value > 0 ? static_cast<std::uint64_t>(value) : 0;
+    _counts[indexFor(clamped)].fetch_add(1, std::memory_order_relaxed);
+    _total.fetch_add(1, std::memory_order_relaxed);
+
+    auto currentMax = _max.load(std::memory_order_relaxed);
+    while(clamped > currentMax
+          && !_max.compare_exchange_weak(currentMax, clamped, std::memory_order_relaxed)){
+    }
+}
+
+void LatencyHistogram::reset() noexcept
+{
+    for(auto& count : _counts){
+        count.store(0, std::memory_order_relaxed);
+    }
+    _total.store(0, std::memory_order_relaxed);
+    _max.store(0, std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::count() const noexcept
+{
+    return _total.load(std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::max() const noexcept
+{
+    return _max.load(std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::percentile(const double percentile) const noexcept
+{
+    // Sum the buckets instead of reading _total so the target rank is consistent
+    // with the counts walked below while recording continues.
+    std::array<std::uint64_t, BucketCount> counts;
+    std::uint64_t total = 0;
+    for(std::size_t index = 0; index < BucketCount; ++index){
+        counts[index] = _counts[index].load(std::memory_order_relaxed);
+        total += counts[index];
+    }
+    if(total == 0) return 0;
+
+    const auto fraction = std::clamp(percentile, 0.0, 100.0) / 100.0;
+    const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(fraction * double(total))));
+    std::uint64_t seen = 0;
+    for(std::size_t index = 0; index < BucketCount; ++index){
+        seen += counts[index];
+        if(seen >= rank){
+            return std::min(highestValueAt(index), max());
+        }
+    }
+    return max();
+}
+
+std::size_t LatencyHistogram::indexFor(std::uint64_t value) noexcept
+{
+    value = std::min(value, MaxTrackableValue);
+    if(value < SubBucketCount) return static_cast<std::size_t>(value);
+
+    const auto shift = mostSignificantBit(value) - (SubBucketBits - 1);
+    const auto subBucket = static_cast<std::size_t>(value >> shift);
+    return SubBucketCount + (shift - 1) * HalfSubBucketCount + (subBucket - HalfSubBucketCount);
+}
+
+std::uint64_t LatencyHistogram::highestValueAt(const std::size_t index) noexcept
+{
+    if(index < SubBucketCount) return index;
+
+    const auto offset = index - SubBucketCount;
+    const auto shift = static_cast<unsigned>(offset / HalfSubBucketCount + 1);
+    const auto subBucket = static_cast<std::uint64_t>(offset % HalfSubBucketCount + HalfSubBucketCount);
+    return (subBucket << shift) + (std::uint64_t(1) << shift) - 1;
+}
@@ -0,0 +1,57 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+/**
+ * @file LatencyHistogram.h
+ * @brief Fixed-size log-linear latency histogram with lock-free recording.
+ *
+ * Values are grouped HDR-style: each power-of-two range is split into 32
+ * linear sub-buckets, so any recorded value is reported within about 3% of its
+ * true value from 1 ns up to about 18 minutes. Recording is one relaxed atomic
+ * increment and never allocates; queries may run concurrently with recording.
+ */
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+class LatencyHistogram
+{
+public:
+    /** Largest value tracked exactly; larger values are counted in the top bucket. */
+    static constexpr std::uint64_t MaxTrackableValue = (std::uint64_t(1) << 40) - 1;
+
+    LatencyHistogram() = default;
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /** Records one value, normally in nanoseconds; negative values count as zero. */
+    void record(std::int64_t value) noexcept;
+    /** Clears all counts; values recorded concurrently may survive the reset. */
+    void reset() noexcept;
+
+    [[nodiscard]] std::uint64_t count() const noexcept;
+    [[nodiscard]] std::uint64_t max() const noexcept;
+    /**
+     * @brief Value at or below which `percentile` percent of recorded values fall.
+     * @param percentile In the range [0, 100], e.g. 99.9 for p999.
+     * @return The upper bound of the matching bucket, or zero when empty.
+     */
+    [[nodiscard]] std::uint64_t percentile(double percentile) const noexcept;
+
+private:
+    static constexpr unsigned SubBucketBits = 6;
+    static constexpr std::size_t SubBucketCount = std::size_t(1) << SubBucketBits;
+    static constexpr std::size_t HalfSubBucketCount = SubBucketCount / 2;
+    static constexpr std::size_t BucketCount = SubBucketCount + (40 - SubBucketBits) * HalfSubBucketCount;
+
+    static std::size_t indexFor(std::uint64_t value) noexcept;
+    static std::uint64_t highestValueAt(std::size_t index) noexcept;
+
+    std::array<std::atomic<std::uint64_t>, BucketCount> _counts{};
+    std::atomic<std::uint64_t> _total{0};
+    std::atomic<std::uint64_t> _max{0};
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,298 @@
+#include "Logger.h"
+#include "ThreadSettings.h"
+
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+namespace {
+
+std::string formatTime(const std::chrono::system_clock::time_point time)
+{
+    const auto seconds = std::chrono::system_clock::to_time_t(time);
+    const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() % 1000;
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
+    std::ostringstream stream;
+    stream << std::put_time(&local, "%Y-%m-%dT%H:%M:%S") << '.' << std::setw(3) << std::setfill('0') << milliseconds;
+    return stream.str();
+}
+
+}
+
+const char* logLevelName(const LogLevel level)
+{
+    switch(level){
+    case LogLevel::Debug:
+        return "DEBUG";
+    case LogLevel::Info:
+        return "INFO";
+    case LogLevel::Warning:
+        return "WARN";
+    case LogLevel::Error:
+        return "ERROR";
+    case LogLevel::Off:
+        break;
+    }
+    return "OFF";
+}
+
+void ConsoleLogSink::write(const LogRecord& record)
+{
+    auto& stream = record.level >= LogLevel::Warning ? std::cerr : std::cout;
+    stream << "[Camera System] " << record.message << '\n';
+}
+
+void ConsoleLogSink::flush()
+{
+    std::cout.flush();
+    std::cerr.flush();
+}
+
+FileLogSink::FileLogSink(const std::string& path)
+    : _file(path, std::ios::out | std::ios::app)
+{
+}
+
+void FileLogSink::write(const LogRecord& record)
+{
+    if(!_file.is_open()) return;
+    _file << formatTime(record.time) << ' ' << logLevelName(record.level) << ' ' << record.message << '\n';
+}
+
+void FileLogSink::flush()
+{
+    if(_file.is_open()) _file.flush();
+}
+
+SocketLogSink::SocketLogSink(std::string path, std::string identifier)
+    : _path(std::move(path))
+    , _identifier(std::move(identifier))
+{
+#if defined(__linux__)
+    sockaddr_un address{};
+    if(_path.size() >= sizeof(address.sun_path)) return;
+    _socket = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if(_socket < 0) return;
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, _path.c_str(), _path.size() + 1);
+    if(::connect(_socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0){
+        ::close(_socket);
+        _socket = -1;
+    }
+#endif
+}
+
+SocketLogSink::~SocketLogSink()
+{
+#if defined(__linux__)
+    if(_socket >= 0) ::close(_socket);
+#endif
+}
+
+void SocketLogSink::write(const LogRecord& record)
+{
+#if defined(__linux__)
+    if(_socket < 0) return;
+    int priority = 6;
+    switch(record.level){
+    case LogLevel::Debug: priority = 7; break;
+    case LogLevel::Warning: priority = 4; break;
+    case LogLevel::Error: priority = 3; break;
+    default: break;
+    }
+    // The plain KEY=value form cannot carry newlines inside a value.
+    std::string message = record.message;
+    for(auto& c : message){
+        if(c == '\n') c = ' ';
+    }
+    const std::string datagram = "PRIORITY=" + std::to_string(priority)
+        + "\nSYSLOG_IDENTIFIER=" + _identifier
+        + "\nMESSAGE=" + message + "\n";
+    ::send(_socket, datagram.data(), datagram.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+#else
+    (void)record;
+#endif
+}
+
+CallbackLogSink::CallbackLogSink(std::function<void(const LogRecord& record)> callback)
+    : _callback(std::move(callback))
+{
+}
+
+void CallbackLogSink::write(const LogRecord& record)
+{
+    if(_callback) _callback(record);
+}
+
+Logger& Logger::instance()
+{
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger()
+{
+    _sinks.emplace_back(_nextSinkId++, std::make_shared<ConsoleLogSink>());
+    _thread = std::thread([this]{ run(); });
+}
+
+Logger::~Logger()
+{
+    {
+        std::lock_guard<std::mutex> lock(_wakeMutex);
+        _stopping = true;
+    }
+    _wake.notify_all();
+    if(_thread.joinable()) _thread.join();
+}
+
+void Logger::log(const LogLevel level, std::string message)
+{
+    LogRecord record;
+    record.level = level;
+    record.time = std::chrono::system_clock::now();
+    record.message = std::move(message);
+    if(!_ring.tryPush(std::move(record))){
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    // Pairs with the fence in run(): either this sees the consumer waiting or it sees the record.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(_waiting.load(std::memory_order_relaxed)){
+        // The consumer holds _wakeMutex until it is inside wait_for(), so the notify cannot fall in between.
+        { std::lock_guard<std::mutex> lock(_wakeMutex); }
+        _wake.notify_one();
+    }
+}
+
+Logger::SinkId Logger::addSink(std::shared_ptr<LogSink> sink)
+{
+    if(!sink) return 0;
+    std::lock_guard<std::mutex> lock(_sinkMutex);
+    const auto id = _nextSinkId++;
+    _sinks.emplace_back(id, std::move(sink));
+    return id;
+}
+
+bool Logger::removeSink(const SinkId id)
+{
+    std::lock_guard<std::mutex> lock(_sinkMutex);
+    for(auto iter = _sinks.begin(); iter != _sinks.end(); ++iter){
+        if(iter->first == id){
+            _sinks.erase(iter);
+            return true;
+        }
+    }
+    return false;
+}
+
+void Logger::clearSinks()
+{
+    std::lock_guard<std::mutex> lock(_sinkMutex);
+    _sinks.clear();
+}
+
+void Logger::flush()
+{
+    if(std::this_thread::get_id() == _thread.get_id()) return;
+    const auto target = _ring.pushed();
+    std::unique_lock<std::mutex> lock(_wakeMutex);
+    _wake.notify_all();
+    _drained.wait(lock, [this, target]{ return _consumed >= target || _stopping; });
+}
+
+void Logger::run()
+{
+    applyCurrentThreadSettings({}, "cam-log");
+    while(true){
+        const auto count = drain();
+        std::unique_lock<std::mutex> lock(_wakeMutex);
+        _consumed += count;
+        _drained.notify_all();
+        if(count > 0) continue;
+        if(_stopping) break;
+        _waiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(_ring.pushed() == _consumed){
+            _wake.wait_for(lock, std::chrono::milliseconds(100));
+        }
+        _waiting.store(false, std::memory_order_relaxed);
+    }
+}
+
+std::size_t Logger::drain()
+{
+    // Sinks run outside the lock, so a slow sink does not block addSink() or removeSink().
+    std::vector<std::pair<SinkId, std::shared_ptr<LogSink>>> sinks;
+    {
+        std::lock_guard<std::mutex> lock(_sinkMutex);
+        sinks = _sinks;
+    }
+    const auto writeAll = [&sinks](const LogRecord& record){
+        for(const auto& [id, sink] : sinks){
+            try{
+                sink->write(record);
+            }catch(...){
+            }
+        }
+    };
+
+    std::size_t count = 0;
+    LogRecord record;
+    while(_ring.tryPop(record)){
+        ++count;
+        writeAll(record);
+    }
+
+    const auto dropped = _dropped.load(std::memory_order_relaxed);
+    const bool reportDropped = dropped != _reportedDropped;
+    if(reportDropped){
+        LogRecord report;
+        report.level = LogLevel::Warning;
+        report.time = std::chrono::system_clock::now();
+        report.message = "[WARN] " + std::to_string(dropped - _reportedDropped) + " log message(s) dropped; the log ring was full.";
+        _reportedDropped = dropped;
+        writeAll(report);
+    }
+
+    if(count > 0 || reportDropped){
+        for(const auto& [id, sink] : sinks){
+            try{
+                sink->flush();
+            }catch(...){
+            }
+        }
+    }
+    return count;
+}
+
+LogRateLimiter::LogRateLimiter(const std::chrono::steady_clock::duration interval) noexcept
+    : _intervalNs(std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count())
+{
+}
+
+bool LogRateLimiter::allow(std::uint64_t& suppressed) noexcept
+{
+    const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    auto next = _nextNs.load(std::memory_order_relaxed);
+    if(now < next || !_nextNs.compare_exchange_strong(next, now + _intervalNs, std::memory_order_relaxed)){
+        _suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    suppressed = _suppressed.exchange(0, std::memory_order_relaxed);
+    return true;
+}
@@ -0,0 +1,212 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+/**
+ * @file Logger.h
+ * @brief Asynchronous logging backend behind `CameraSystem::syslog()`.
+ *
+ * Producers move a finished record into a lock-free ring and return; a
+ * `cam-log` thread hands records to the sinks. A full ring drops the record
+ * and counts it, so a slow terminal or pipe can never stall acquisition.
+ * The `CAMERA_LOG*` macros check the level first, so a disabled message is
+ * never formatted and allocates nothing.
+ */
+
+#include "MpscRing.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+enum class LogLevel
+{
+    Debug,
+    Info,
+    Warning,
+    Error,
+    /** As a threshold, disables logging. */
+    Off
+};
+
+const char* logLevelName(LogLevel level);
+
+struct LogRecord
+{
+    LogLevel level = LogLevel::Info;
+    std::chrono::system_clock::time_point time;
+    std::string message;
+};
+
+/** Sinks are called from the logger thread only, one record at a time. */
+class LogSink
+{
+public:
+    virtual ~LogSink() = default;
+    virtual void write(const LogRecord& record) = 0;
+    /** Called after every batch of records. */
+    virtual void flush() {}
+};
+
+/** The previous `syslog()` output: `[Camera System] message`, warnings and errors on stderr. */
+class ConsoleLogSink : public LogSink
+{
+public:
+    void write(const LogRecord& record) override;
+    void flush() override;
+};
+
+/** Appends `time level message` lines to a file. */
+class FileLogSink : public LogSink
+{
+public:
+    explicit FileLogSink(const std::string& path);
+    [[nodiscard]] bool isOpen() const { return _file.is_open(); }
+    void write(const LogRecord& record) override;
+    void flush() override;
+
+private:
+    std::ofstream _file;
+};
+
+/**
+ * @brief Sends each record as a datagram in the journald native format.
+ * @note Available on Linux only; elsewhere the sink never opens.
+ */
+class SocketLogSink : public LogSink
+{
+public:
+    explicit SocketLogSink(std::string path = "/run/systemd/journal/socket",
+                           std::string identifier = "camera");
+    ~SocketLogSink() override;
+    SocketLogSink(const SocketLogSink&) = delete;
+    SocketLogSink& operator=(const SocketLogSink&) = delete;
+
+    [[nodiscard]] bool isOpen() const { return _socket >= 0; }
+    void write(const LogRecord& record) override;
+
+private:
+    const std::string _path;
+    const std::string _identifier;
+    int _socket = -1;
+};
+
+class CallbackLogSink : public LogSink
+{
+public:
+    explicit CallbackLogSink(std::function<void(const LogRecord& record)> callback);
+    void write(const LogRecord& record) override;
+
+private:
+    const std::function<void(const LogRecord& record)> _callback;
+};
+
+class Logger
+{
+public:
+    using SinkId = std::size_t;
+
+    /** Process-wide logger; starts with a `ConsoleLogSink` and the `Debug` threshold. */
+    static Logger& instance();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    [[nodiscard]] bool enabled(const LogLevel level) const noexcept
+    {
+        return level != LogLevel::Off && level >= _threshold.load(std::memory_order_relaxed);
+    }
+    void setLevel(LogLevel threshold) noexcept { _threshold.store(threshold, std::memory_order_relaxed); }
+    [[nodiscard]] LogLevel level() const noexcept { return _threshold.load(std::memory_order_relaxed); }
+
+    /** Queues the message without checking the level; use the macros or `enabled()` first. */
+    void log(LogLevel level, std::string message);
+
+    SinkId addSink(std::shared_ptr<LogSink> sink);
+    /** A drain already running may still write its batch to the removed sink, which it keeps alive until then. */
+    bool removeSink(SinkId id);
+    void clearSinks();
+
+    /** Blocks until every record queued before the call reached the sinks. */
+    void flush();
+    /** Records dropped because the ring was full. */
+    [[nodiscard]] std::uint64_t droppedCount() const noexcept { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr std::size_t RingCapacity = 8192;
+
+    Logger();
+    ~Logger();
+
+    void run();
+    std::size_t drain();
+
+    std::atomic<LogLevel> _threshold{LogLevel::Debug};
+    MpscRing<LogRecord> _ring{RingCapacity};
+    std::atomic<std::uint64_t> _dropped{0};
+    std::uint64_t _reportedDropped = 0;
+    // Records taken from the ring by the logger thread; flush() waits for it to reach the ring's push count.
+    std::size_t _consumed = 0;
+
+    std::mutex _sinkMutex;
+    std::vector<std::pair<SinkId, std::shared_ptr<LogSink>>> _sinks;
+    SinkId _nextSinkId = 1;
+
+    std::mutex _wakeMutex;
+    std::condition_variable _wake;
+    std::condition_variable _drained;
+    std::atomic<bool> _waiting{false};
+    bool _stopping = false;
+    std::thread _thread;
+};
+
+/** Lets one message through per interval at a call site and counts the rest. */
+class LogRateLimiter
+{
+public:
+    explicit LogRateLimiter(std::chrono::steady_clock::duration interval) noexcept;
+    /** @param suppressed Set to the number of messages held back since the last one that passed. */
+    bool allow(std::uint64_t& suppressed) noexcept;
+
+private:
+    const std::int64_t _intervalNs;
+    std::atomic<std::int64_t> _nextNs{0};
+    std::atomic<std::uint64_t> _suppressed{0};
+};
+
+#define CAMERA_LOG(level, message) \
+    do{ \
+        auto& cameraLogger_ = ::Logger::instance(); \
+        if(cameraLogger_.enabled(level)) cameraLogger_.log((level), (message)); \
+    }while(false)
+
+#define CAMERA_LOG_DEBUG(message) CAMERA_LOG(::LogLevel::Debug, message)
+#define CAMERA_LOG_INFO(message) CAMERA_LOG(::LogLevel::Info, message)
+#define CAMERA_LOG_WARN(message) CAMERA_LOG(::LogLevel::Warning, message)
+#define CAMERA_LOG_ERROR(message) CAMERA_LOG(::LogLevel::Error, message)
+
+/** At most one message per `interval` from this call site; the next one reports how many were suppressed. */
+#define CAMERA_LOG_RATE_LIMITED(level, interval, message) \
+    do{ \
+        static ::LogRateLimiter cameraLogLimiter_(interval); \
+        auto& cameraLogger_ = ::Logger::instance(); \
+        std::uint64_t cameraLogSuppressed_ = 0; \
+        if(cameraLogger_.enabled(level) && cameraLogLimiter_.allow(cameraLogSuppressed_)){ \
+            std::string cameraLogMessage_(message); \
+            if(cameraLogSuppressed_ > 0){ \
+                cameraLogMessage_ += " (" + std::to_string(cameraLogSuppressed_) + " similar suppressed)"; \
+            } \
+            cameraLogger_.log((level), std::move(cameraLogMessage_)); \
+        } \
+    }while(false)
+
+#endif // LOGGER_H
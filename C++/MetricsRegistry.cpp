@@ -0,0 +1,449 @@
+#include "MetricsRegistry.h"
+#include "ThreadSettings.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <locale>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+namespace {
+
+const char* typeName(const MetricType type)
+{
+    switch(type){
+    case MetricType::Counter:
+        return "counter";
+    case MetricType::Gauge:
+        return "gauge";
+    case MetricType::Histogram:
+        return "histogram";
+    }
+    return "untyped";
+}
+
+std::string formatValue(const double value)
+{
+    if(std::isnan(value)) return "NaN";
+    if(std::isinf(value)) return value > 0 ? "+Inf" : "-Inf";
+    std::ostringstream stream;
+    stream.imbue(std::locale::classic());
+    stream << std::setprecision(15) << value;
+    return stream.str();
+}
+
+std::string escape(const std::string& value, const bool quoted)
+{
+    std::string escaped;
+    escaped.reserve(value.size());
+    for(const auto c : value){
+        if(c == '\\'){
+            escaped += "\\\\";
+        }else if(c == '\n'){
+            escaped += "\\n";
+        }else if(c == '"' && quoted){
+            escaped += "\\\"";
+        }else{
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+void appendLabels(std::string& text, const MetricLabels& labels, const char* extraName = nullptr, const std::string& extraValue = {})
+{
+    if(labels.empty() && !extraName) return;
+    text += '{';
+    bool first = true;
+    for(const auto& [name, value] : labels){
+        if(!first) text += ',';
+        first = false;
+        text += name + "=\"" + escape(value, true) + '"';
+    }
+    if(extraName){
+        if(!first) text += ',';
+        text += std::string(extraName) + "=\"" + extraValue + '"';
+    }
+    text += '}';
+}
+
+void addToDouble(std::atomic<double>& target, const double amount) noexcept
+{
+    auto current = target.load(std::memory_order_relaxed);
+    while(!target.compare_exchange_weak(current, current + amount, std::memory_order_relaxed)){
+    }
+}
+
+}
+
+MetricHistogram::MetricHistogram(std::vector<double> upperBounds)
+    : _upperBounds([&upperBounds]{
+          std::sort(upperBounds.begin(), upperBounds.end());
+          upperBounds.erase(std::unique(upperBounds.begin(), upperBounds.end()), upperBounds.end());
+          return std::move(upperBounds);
+      }())
+    , _buckets(std::make_unique<std::atomic<std::uint64_t>[]>(_upperBounds.size() + 1))
+{
+    for(std::size_t index = 0; index <= _upperBounds.size(); ++index){
+        _buckets[index].store(0, std::memory_order_relaxed);
+    }
+}
+
+void MetricHistogram::observe(const double value) noexcept
+{
+    // Bucket lists are short, so a linear scan beats a binary search here.
+    std::size_t index = 0;
+    while(index < _upperBounds.size() && value > _upperBounds[index]) ++index;
+    _buckets[index].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    addToDouble(_sum, value);
+}
+
+std::vector<std::uint64_t> MetricHistogram::cumulativeCounts() const
+{
+    std::vector<std::uint64_t> counts(_upperBounds.size() + 1);
+    std::uint64_t total = 0;
+    for(std::size_t index = 0; index < counts.size(); ++index){
+        total += _buckets[index].load(std::memory_order_relaxed);
+        counts[index] = total;
+    }
+    return counts;
+}
+
+const MetricFamilySnapshot* MetricsSnapshot::find(const std::string& name) const
+{
+    const auto iter = std::find_if(families.begin(), families.end(), [&name](const MetricFamilySnapshot& family){
+        return family.name == name;
+    });
+    return iter == families.end() ? nullptr : &*iter;
+}
+
+const MetricSample* MetricsSnapshot::find(const std::string& name, const MetricLabels& labels) const
+{
+    const auto* family = find(name);
+    if(!family) return nullptr;
+    const auto iter = std::find_if(family->samples.begin(), family->samples.end(), [&labels](const MetricSample& sample){
+        return sample.labels == labels;
+    });
+    return iter == family->samples.end() ? nullptr : &*iter;
+}
+
+MetricsRegistry& MetricsRegistry::instance()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+template<typename Metric, typename Factory>
+std::shared_ptr<Metric> MetricsRegistry::findOrCreate(const std::string& name, const std::string& help,
+                                                      const MetricType type, const MetricLabels& labels, Factory factory)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto [iter, inserted] = _families.try_emplace(name);
+    auto& family = iter->second;
+    if(inserted){
+        family.help = help;
+        family.type = type;
+    }else if(family.type != type){
+        throw std::invalid_argument("Metric " + name + " is already registered as a " + typeName(family.type) + ".");
+    }
+
+    // Registration is rare, so released series are pruned here rather than on every snapshot.
+    family.series.erase(std::remove_if(family.series.begin(), family.series.end(), [](const Series& series){
+        return series.metric.expired();
+    }), family.series.end());
+    for(const auto& series : family.series){
+        if(series.labels != labels) continue;
+        if(auto metric = series.metric.lock()) return std::static_pointer_cast<Metric>(metric);
+    }
+
+    auto metric = factory();
+    family.series.push_back({labels, metric});
+    return metric;
+}
+
+std::shared_ptr<MetricCounter> MetricsRegistry::counter(const std::string& name, const std::string& help, const MetricLabels& labels)
+{
+    return findOrCreate<MetricCounter>(name, help, MetricType::Counter, labels, []{
+        return std::make_shared<MetricCounter>();
+    });
+}
+
+std::shared_ptr<MetricGauge> MetricsRegistry::gauge(const std::string& name, const std::string& help, const MetricLabels& labels)
+{
+    return findOrCreate<MetricGauge>(name, help, MetricType::Gauge, labels, []{
+        return std::make_shared<MetricGauge>();
+    });
+}
+
+std::shared_ptr<MetricHistogram> MetricsRegistry::histogram(const std::string& name, const std::string& help,
+                                                            std::vector<double> upperBounds, const MetricLabels& labels)
+{
+    return findOrCreate<MetricHistogram>(name, help, MetricType::Histogram, labels, [&upperBounds]{
+        return std::make_shared<MetricHistogram>(std::move(upperBounds));
+    });
+}
+
+MetricsSnapshot MetricsRegistry::snapshot() const
+{
+    MetricsSnapshot snapshot;
+    snapshot.time = std::chrono::system_clock::now();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    snapshot.families.reserve(_families.size());
+    for(const auto& [name, family] : _families){
+        MetricFamilySnapshot familySnapshot;
+        familySnapshot.name = name;
+        familySnapshot.help = family.help;
+        familySnapshot.type = family.type;
+        for(const auto& series : family.series){
+            const auto metric = series.metric.lock();
+            if(!metric) continue;
+            MetricSample sample;
+            sample.labels = series.labels;
+            switch(family.type){
+            case MetricType::Counter:
+                sample.value = static_cast<double>(std::static_pointer_cast<MetricCounter>(metric)->value());
+                break;
+            case MetricType::Gauge:
+                sample.value = std::static_pointer_cast<MetricGauge>(metric)->value();
+                break;
+            case MetricType::Histogram:{
+                const auto histogram = std::static_pointer_cast<MetricHistogram>(metric);
+                sample.upperBounds = histogram->upperBounds();
+                sample.cumulativeCounts = histogram->cumulativeCounts();
+                // Derived from the buckets so count always matches the +Inf bucket.
+                sample.count = sample.cumulativeCounts.back();
+                sample.sum = histogram->sum();
+                break;
+            }
+            }
+            familySnapshot.samples.push_back(std::move(sample));
+        }
+        if(!familySnapshot.samples.empty()){
+            snapshot.families.push_back(std::move(familySnapshot));
+        }
+    }
+    return snapshot;
+}
+
+std::string formatPrometheusText(const MetricsSnapshot& snapshot)
+{
+    std::string text;
+    for(const auto& family : snapshot.families){
+        if(!family.help.empty()){
+            text += "# HELP " + family.name + ' ' + escape(family.help, false) + '\n';
+        }
+        text += "# TYPE " + family.name + ' ' + typeName(family.type) + '\n';
+        for(const auto& sample : family.samples){
+            if(family.type != MetricType::Histogram){
+                text += family.name;
+                appendLabels(text, sample.labels);
+                text += ' ' + formatValue(sample.value) + '\n';
+                continue;
+            }
+            for(std::size_t index = 0; index < sample.cumulativeCounts.size(); ++index){
+                const auto bound = index < sample.upperBounds.size()
+                    ? formatValue(sample.upperBounds[index]) : std::string("+Inf");
+                text += family.name + "_bucket";
+                appendLabels(text, sample.labels, "le", bound);
+                text += ' ' + std::to_string(sample.cumulativeCounts[index]) + '\n';
+            }
+            text += family.name + "_sum";
+            appendLabels(text, sample.labels);
+            text += ' ' + formatValue(sample.sum) + '\n';
+            text += family.name + "_count";
+            appendLabels(text, sample.labels);
+            text += ' ' + std::to_string(sample.count) + '\n';
+        }
+    }
+    return text;
+}
+
+PrometheusExporter::PrometheusExporter(MetricsRegistry& registry)
+    : _registry(registry)
+{
+}
+
+PrometheusExporter::~PrometheusExporter()
+{
+    stop();
+}
+
+bool PrometheusExporter::writeFile(const std::string& path) const
+{
+    namespace fs = std::filesystem;
+    std::error_code error;
+    const fs::path target(path);
+    const fs::path temporary(path + ".tmp");
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if(!file) return false;
+        file << formatPrometheusText(_registry.snapshot());
+        if(!file.flush()) return false;
+    }
+    fs::rename(temporary, target, error);
+    if(error){
+        fs::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+bool PrometheusExporter::startFileExport(const std::string& path, const std::chrono::milliseconds interval)
+{
+    stopFileExport();
+    if(path.empty() || !writeFile(path)) return false;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _fileStopping = false;
+    _fileThread = std::thread([this, path, interval]{ runFileExport(path, interval); });
+    return true;
+}
+
+bool PrometheusExporter::startSocketServer(const std::string& path)
+{
+    stopSocketServer();
+#if defined(__linux__)
+    sockaddr_un address{};
+    if(path.empty() || path.size() >= sizeof(address.sun_path)) return false;
+    const int listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(listener < 0) return false;
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    ::unlink(path.c_str());
+    if(::bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+       || ::listen(listener, 8) != 0){
+        ::close(listener);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _socketStopping.store(false, std::memory_order_relaxed);
+    _listener = listener;
+    _socketPath = path;
+    _socketThread = std::thread([this, listener]{ runSocketServer(listener); });
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+void PrometheusExporter::stop()
+{
+    stopFileExport();
+    stopSocketServer();
+}
+
+bool PrometheusExporter::isFileExportRunning() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _fileThread.joinable();
+}
+
+bool PrometheusExporter::isSocketServerRunning() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _socketThread.joinable();
+}
+
+void PrometheusExporter::stopFileExport()
+{
+    std::thread thread;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _fileStopping = true;
+        thread = std::move(_fileThread);
+    }
+    _fileWake.notify_all();
+    if(thread.joinable()) thread.join();
+}
+
+void PrometheusExporter::stopSocketServer()
+{
+    std::thread thread;
+    int listener = -1;
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        thread = std::move(_socketThread);
+        listener = std::exchange(_listener, -1);
+        path = std::move(_socketPath);
+        _socketPath.clear();
+    }
+    if(listener < 0) return;
+#if defined(__linux__)
+    _socketStopping.store(true, std::memory_order_relaxed);
+    // Wakes the blocked accept().
+    ::shutdown(listener, SHUT_RDWR);
+    if(thread.joinable()) thread.join();
+    ::close(listener);
+    ::unlink(path.c_str());
+#endif
+}
+
+void PrometheusExporter::runFileExport(const std::string path, const std::chrono::milliseconds interval)
+{
+    applyCurrentThreadSettings({}, "cam-metrics");
+    std::unique_lock<std::mutex> lock(_mutex);
+    while(!_fileWake.wait_for(lock, interval, [this]{ return _fileStopping; })){
+        lock.unlock();
+        writeFile(path);
+        lock.lock();
+    }
+}
+
+void PrometheusExporter::runSocketServer(const int listener)
+{
+    applyCurrentThreadSettings({}, "cam-metrics-srv");
+#if defined(__linux__)
+    while(!_socketStopping.load(std::memory_order_relaxed)){
+        const int client = ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+        if(client < 0){
+            if(errno == EINTR || errno == ECONNABORTED) continue;
+            break;
+        }
+        // A silent or stalled client must not hold the server for long.
+        timeval timeout{};
+        timeout.tv_sec = 1;
+        ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        ::setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+        // Read the request head, if any; a plain reader that sends nothing still gets the response after the timeout.
+        std::string request;
+        char buffer[1024];
+        while(request.size() < 8192 && request.find("\r\n\r\n") == std::string::npos){
+            const auto received = ::recv(client, buffer, sizeof(buffer), 0);
+            if(received <= 0) break;
+            request.append(buffer, static_cast<std::size_t>(received));
+        }
+
+        const auto body = formatPrometheusText(_registry.snapshot());
+        const auto response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: "
+            + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+        std::size_t sent = 0;
+        while(sent < response.size()){
+            const auto written = ::send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+            if(written <= 0) break;
+            sent += static_cast<std::size_t>(written);
+        }
+        ::close(client);
+    }
+#else
+    (void)listener;
+#endif
+}
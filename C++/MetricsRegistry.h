@@ -0,0 +1,210 @@
+#ifndef METRICSREGISTRY_H
+#define METRICSREGISTRY_H
+
+/**
+ * @file MetricsRegistry.h
+ * @brief Named counters, gauges, and histograms with a Prometheus text exporter.
+ *
+ * Owners register a metric once and keep the returned handle; updating it is
+ * a relaxed atomic operation that never locks or allocates, so it is safe on
+ * the frame path. The registry only holds weak references, and a series
+ * disappears from snapshots when its last handle is released.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/** Label name and value pairs, exported in the given order. */
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+enum class MetricType
+{
+    Counter,
+    Gauge,
+    Histogram
+};
+
+/** Monotonic count; never reset, so rates stay correct across grabs. */
+class MetricCounter
+{
+public:
+    void add(const std::uint64_t amount = 1) noexcept { _value.fetch_add(amount, std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t value() const noexcept { return _value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> _value{0};
+};
+
+class MetricGauge
+{
+public:
+    void set(const double value) noexcept { _value.store(value, std::memory_order_relaxed); }
+    [[nodiscard]] double value() const noexcept { return _value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> _value{0.0};
+};
+
+/** Counts observations into fixed buckets chosen at registration. */
+class MetricHistogram
+{
+public:
+    /** @param upperBounds Ascending bucket bounds; the `+Inf` bucket is implicit. */
+    explicit MetricHistogram(std::vector<double> upperBounds);
+
+    void observe(double value) noexcept;
+
+    [[nodiscard]] const std::vector<double>& upperBounds() const noexcept { return _upperBounds; }
+    /** Cumulative count per bound followed by the `+Inf` bucket, as Prometheus expects. */
+    [[nodiscard]] std::vector<std::uint64_t> cumulativeCounts() const;
+    [[nodiscard]] std::uint64_t count() const noexcept { return _count.load(std::memory_order_relaxed); }
+    [[nodiscard]] double sum() const noexcept { return _sum.load(std::memory_order_relaxed); }
+
+private:
+    const std::vector<double> _upperBounds;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> _buckets;
+    std::atomic<std::uint64_t> _count{0};
+    std::atomic<double> _sum{0.0};
+};
+
+struct MetricSample
+{
+    MetricLabels labels;
+    /** Counter or gauge value; unused for histograms. */
+    double value = 0.0;
+    std::vector<double> upperBounds;
+    std::vector<std::uint64_t> cumulativeCounts;
+    std::uint64_t count = 0;
+    double sum = 0.0;
+};
+
+struct MetricFamilySnapshot
+{
+    std::string name;
+    std::string help;
+    MetricType type = MetricType::Counter;
+    std::vector<MetricSample> samples;
+};
+
+/** Values read at one point in time; individual series are read independently. */
+struct MetricsSnapshot
+{
+    std::chrono::system_clock::time_point time;
+    /** Sorted by name; families whose series were all released are omitted. */
+    std::vector<MetricFamilySnapshot> families;
+
+    /** @return Null when no family has `name`. */
+    [[nodiscard]] const MetricFamilySnapshot* find(const std::string& name) const;
+    /** @return Null when the family or the series with exactly `labels` is missing. */
+    [[nodiscard]] const MetricSample* find(const std::string& name, const MetricLabels& labels) const;
+};
+
+class MetricsRegistry
+{
+public:
+    /** Process-wide registry that every `Camera` reports to. */
+    static MetricsRegistry& instance();
+
+    MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    /**
+     * @brief Returns the live series for `name` and `labels`, creating it when needed.
+     * @throws std::invalid_argument When `name` is already registered with another type.
+     */
+    std::shared_ptr<MetricCounter> counter(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+    std::shared_ptr<MetricGauge> gauge(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+    /** The bounds of an existing live series win over `upperBounds`. */
+    std::shared_ptr<MetricHistogram> histogram(const std::string& name, const std::string& help,
+                                               std::vector<double> upperBounds, const MetricLabels& labels = {});
+
+    [[nodiscard]] MetricsSnapshot snapshot() const;
+
+private:
+    struct Series
+    {
+        MetricLabels labels;
+        std::weak_ptr<void> metric;
+    };
+
+    struct Family
+    {
+        std::string help;
+        MetricType type = MetricType::Counter;
+        std::vector<Series> series;
+    };
+
+    template<typename Metric, typename Factory>
+    std::shared_ptr<Metric> findOrCreate(const std::string& name, const std::string& help,
+                                         MetricType type, const MetricLabels& labels, Factory factory);
+
+    mutable std::mutex _mutex;
+    std::map<std::string, Family> _families;
+};
+
+/** Renders a snapshot in the Prometheus text exposition format, version 0.0.4. */
+std::string formatPrometheusText(const MetricsSnapshot& snapshot);
+
+/**
+ * @brief Publishes a registry for scraping, as a file, a Unix socket, or both.
+ *
+ * The file suits the node exporter's textfile collector: it is rewritten
+ * through a temporary file and a rename, so a scrape never reads half a file.
+ * The socket answers every connection with one HTTP/1.0 response, so
+ * `curl --unix-socket <path> http://localhost/metrics` works as well as a
+ * plain reader.
+ */
+class PrometheusExporter
+{
+public:
+    explicit PrometheusExporter(MetricsRegistry& registry = MetricsRegistry::instance());
+    ~PrometheusExporter();
+    PrometheusExporter(const PrometheusExporter&) = delete;
+    PrometheusExporter& operator=(const PrometheusExporter&) = delete;
+
+    /** Writes one snapshot now. */
+    bool writeFile(const std::string& path) const;
+    /** Rewrites `path` every `interval` on a `cam-metrics` thread; replaces an earlier file export. */
+    bool startFileExport(const std::string& path, std::chrono::milliseconds interval = std::chrono::seconds(5));
+    /**
+     * @brief Listens on a Unix stream socket at `path` on a `cam-metrics-srv` thread.
+     * @note Linux only; elsewhere it returns `false`. A stale socket file at `path` is replaced.
+     */
+    bool startSocketServer(const std::string& path);
+    /** Stops both exports and removes the socket file. */
+    void stop();
+
+    [[nodiscard]] bool isFileExportRunning() const;
+    [[nodiscard]] bool isSocketServerRunning() const;
+
+private:
+    void stopFileExport();
+    void stopSocketServer();
+    void runFileExport(std::string path, std::chrono::milliseconds interval);
+    void runSocketServer(int listener);
+
+    MetricsRegistry& _registry;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _fileWake;
+    bool _fileStopping = false;
+    std::thread _fileThread;
+
+    std::atomic<bool> _socketStopping{false};
+    int _listener = -1;
+    std::string _socketPath;
+    std::thread _socketThread;
+};
+
+#endif // METRICSREGISTRY_H
@@ -0,0 +1,93 @@
+#ifndef MPSCRING_H
+#define MPSCRING_H
+
+/**
+ * @file MpscRing.h
+ * @brief Bounded lock-free multi-producer/single-consumer ring buffer.
+ *
+ * Any number of threads may call `tryPush()` while one thread calls
+ * `tryPop()`. Every slot carries a sequence number: producers claim a
+ * position with one compare-and-swap and publish the slot by advancing its
+ * sequence, so a full ring fails the push instead of blocking the producer.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+template<typename T>
+class MpscRing
+{
+public:
+    /** Creates a ring holding at least `capacity` elements, rounded up to a power of two. */
+    explicit MpscRing(const std::size_t capacity)
+    {
+        std::size_t size = 2;
+        while(size < capacity) size <<= 1;
+        _slots = std::make_unique<Slot[]>(size);
+        for(std::size_t index = 0; index < size; ++index){
+            _slots[index].sequence.store(index, std::memory_order_relaxed);
+        }
+        _mask = size - 1;
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    /** Producer side; returns `false` and leaves `value` untouched when full. */
+    bool tryPush(T&& value)
+    {
+        auto position = _tail.load(std::memory_order_relaxed);
+        while(true){
+            auto& slot = _slots[position & _mask];
+            const auto sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+            if(difference == 0){
+                if(_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)){
+                    slot.value = std::move(value);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }else if(difference < 0){
+                return false;
+            }else{
+                position = _tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /** Consumer side; moves the oldest published element out and returns `false` when empty. */
+    bool tryPop(T& value)
+    {
+        auto& slot = _slots[_head & _mask];
+        if(slot.sequence.load(std::memory_order_acquire) != _head + 1) return false;
+        value = std::move(slot.value);
+        slot.value = T{};
+        slot.sequence.store(_head + _mask + 1, std::memory_order_release);
+        ++_head;
+        return true;
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return _mask + 1; }
+    /** Positions claimed by producers so far, including pushes still being written. */
+    [[nodiscard]] std::size_t pushed() const noexcept { return _tail.load(std::memory_order_acquire); }
+
+private:
+    static constexpr std::size_t CacheLineSize = 64;
+
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence{0};
+        T value{};
+    };
+
+    std::unique_ptr<Slot[]> _slots;
+    std::size_t _mask = 0;
+    // Consumer-owned.
+    alignas(CacheLineSize) std::size_t _head = 0;
+    alignas(CacheLineSize) std::atomic<std::size_t> _tail{0};
+};
+
+#endif // MPSCRING_H
@@ -0,0 +1,182 @@
+#include "ParameterCache.h"
+
+#include <thread>
+
+namespace {
+
+// Feature names tried in order for each CachedParameter.
+constexpr std::array<std::array<const char*, 3>, CachedParameterCount> FeatureCandidates = {{
+    {"ExposureTime", "ExposureTimeAbs", nullptr},
+    {"Gain", "GainAbs", "GainRaw"},
+    {"Width", nullptr, nullptr},
+    {"Height", nullptr, nullptr},
+    {"OffsetX", nullptr, nullptr},
+    {"OffsetY", nullptr, nullptr},
+    {"AcquisitionFrameRate", "AcquisitionFrameRateAbs", nullptr},
+}};
+
+}
+
+void ParameterCache::attach(GenApi::INodeMap& nodeMap)
+{
+    std::array<Handle, CachedParameterCount> handles{};
+    for(std::size_t index = 0; index < CachedParameterCount; ++index){
+        for(const char* name : FeatureCandidates[index]){
+            if(!name) break;
+            try{
+                auto* node = nodeMap.GetNode(name);
+                if(!node || !GenApi::IsAvailable(node)) continue;
+                auto* real = dynamic_cast<GenApi::IFloat*>(node);
+                auto* integer = real ? nullptr : dynamic_cast<GenApi::IInteger*>(node);
+                if(!real && !integer) continue;
+                handles[index] = {name, node, real, integer};
+                break;
+            }catch(const GenICam::GenericException&){
+            }
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _handles = std::move(handles);
+    }
+    refreshAll();
+}
+
+void ParameterCache::detach()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for(std::size_t index = 0; index < CachedParameterCount; ++index){
+        _handles[index] = {};
+        ++_generations[index];
+        publishLocked(index, std::nullopt);
+    }
+}
+
+ParameterSnapshot ParameterCache::snapshot() const
+{
+    ParameterSnapshot snapshot;
+    while(true){
+        const auto begin = _sequence.load(std::memory_order_acquire);
+        if(begin & 1){
+            std::this_thread::yield();
+            continue;
+        }
+        for(std::size_t index = 0; index < CachedParameterCount; ++index){
+            if(_available[index].load(std::memory_order_relaxed)){
+                snapshot.values[index] = _values[index].load(std::memory_order_relaxed);
+            }else{
+                snapshot.values[index].reset();
+            }
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(_sequence.load(std::memory_order_relaxed) == begin){
+            snapshot.version = begin / 2;
+            return snapshot;
+        }
+    }
+}
+
+std::optional<double> ParameterCache::value(const CachedParameter parameter) const
+{
+    const auto index = static_cast<std::size_t>(parameter);
+    while(true){
+        const auto begin = _sequence.load(std::memory_order_acquire);
+        if(begin & 1){
+            std::this_thread::yield();
+            continue;
+        }
+        const bool available = _available[index].load(std::memory_order_relaxed);
+        const double value = _values[index].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(_sequence.load(std::memory_order_relaxed) == begin){
+            return available ? std::optional<double>(value) : std::nullopt;
+        }
+    }
+}
+
+std::uint64_t ParameterCache::version() const noexcept
+{
+    return _sequence.load(std::memory_order_acquire) / 2;
+}
+
+std::string ParameterCache::featureName(const CachedParameter parameter) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _handles[static_cast<std::size_t>(parameter)].feature;
+}
+
+GenApi::INode* ParameterCache::node(const std::string& feature) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for(const auto& handle : _handles){
+        if(handle.node && handle.feature == feature) return handle.node;
+    }
+    return nullptr;
+}
+
+bool ParameterCache::refresh(const GenApi::INode* node)
+{
+    if(!node) return false;
+    std::size_t found = CachedParameterCount;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for(std::size_t index = 0; index < CachedParameterCount; ++index){
+            if(_handles[index].node == node){
+                found = index;
+                break;
+            }
+        }
+    }
+    if(found == CachedParameterCount) return false;
+    refreshIndex(found);
+    return true;
+}
+
+void ParameterCache::refreshAll()
+{
+    for(std::size_t index = 0; index < CachedParameterCount; ++index){
+        refreshIndex(index);
+    }
+}
+
+void ParameterCache::refreshIndex(const std::size_t index)
+{
+    Handle handle;
+    std::uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        handle = _handles[index];
+        generation = ++_generations[index];
+    }
+
+    std::optional<double> value;
+    if(handle.node){
+        try{
+            if(GenApi::IsReadable(handle.node)){
+                value = handle.real ? handle.real->GetValue() : static_cast<double>(handle.integer->GetValue());
+            }
+        }catch(const GenICam::GenericException&){
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    // A later invalidation started its own read, which saw a newer device value.
+    if(_generations[index] != generation) return;
+    publishLocked(index, value);
+}
+
+void ParameterCache::publishLocked(const std::size_t index, const std::optional<double> value)
+{
+    const bool available = value.has_value();
+    const double stored = value.value_or(0.0);
+    if(_available[index].load(std::memory_order_relaxed) == available
+        && _values[index].load(std::memory_order_relaxed) == stored){
+        return;
+    }
+    const auto sequence = _sequence.load(std::memory_order_relaxed);
+    _sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _available[index].store(available, std::memory_order_relaxed);
+    _values[index].store(stored, std::memory_order_relaxed);
+    _sequence.store(sequence + 2, std::memory_order_release);
+}
@@ -0,0 +1,107 @@
+#ifndef PARAMETERCACHE_H
+#define PARAMETERCACHE_H
+
+/**
+ * @file ParameterCache.h
+ * @brief Shadow copies of frequently read camera parameters.
+ *
+ * Handles are resolved once when the camera opens. A value is read from the
+ * node map again only when a node notification or one of the camera's own
+ * writes invalidates it, so processing threads read exposure, gain, and ROI
+ * without GenApi calls. Readers copy the values under a sequence lock and
+ * retry when an update raced with the copy; they never block the updater.
+ */
+
+#include <pylon/PylonIncludes.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+
+enum class CachedParameter : std::size_t
+{
+    /** Microseconds; `ExposureTimeAbs` on older cameras. */
+    ExposureTime,
+    /** dB, or raw gain units on cameras that only have `GainRaw`; follows `GainSelector`. */
+    Gain,
+    Width,
+    Height,
+    OffsetX,
+    OffsetY,
+    AcquisitionFrameRate,
+    Count
+};
+
+inline constexpr std::size_t CachedParameterCount = static_cast<std::size_t>(CachedParameter::Count);
+
+struct ParameterSnapshot
+{
+    /** Advances whenever a cached value changes; equal versions hold equal values. */
+    std::uint64_t version = 0;
+    /** Indexed by `CachedParameter`; empty when the camera lacks the feature or is closed. */
+    std::array<std::optional<double>, CachedParameterCount> values{};
+
+    [[nodiscard]] std::optional<double> operator[](CachedParameter parameter) const
+    {
+        return values[static_cast<std::size_t>(parameter)];
+    }
+};
+
+class ParameterCache
+{
+public:
+    ParameterCache() = default;
+
+    ParameterCache(const ParameterCache&) = delete;
+    ParameterCache& operator=(const ParameterCache&) = delete;
+
+    /** Resolves the parameter handles of an open camera and reads every value. */
+    void attach(GenApi::INodeMap& nodeMap);
+    /** Drops the handles; every parameter reads as empty. */
+    void detach();
+
+    /** Makes no GenApi calls and never waits for the updater. */
+    [[nodiscard]] ParameterSnapshot snapshot() const;
+    [[nodiscard]] std::optional<double> value(CachedParameter parameter) const;
+    [[nodiscard]] std::uint64_t version() const noexcept;
+
+    /** Feature the parameter resolved to, e.g. `ExposureTimeAbs`; empty while detached or unsupported. */
+    [[nodiscard]] std::string featureName(CachedParameter parameter) const;
+    /** Handle resolved at attach for `feature`, or null when the feature is not cached. */
+    [[nodiscard]] GenApi::INode* node(const std::string& feature) const;
+
+    /** Re-reads the parameter behind `node`; `false` when the node is not cached. */
+    bool refresh(const GenApi::INode* node);
+    void refreshAll();
+
+private:
+    struct Handle
+    {
+        std::string feature;
+        GenApi::INode* node = nullptr;
+        GenApi::IFloat* real = nullptr;
+        GenApi::IInteger* integer = nullptr;
+    };
+
+    void refreshIndex(std::size_t index);
+    /** Stores one value between two sequence increments; requires `_mutex`. */
+    void publishLocked(std::size_t index, std::optional<double> value);
+
+    // Guards the handles and generations; never held across GenApi calls, so a
+    // node callback raised by a read or write can refresh without deadlocking.
+    mutable std::mutex _mutex;
+    std::array<Handle, CachedParameterCount> _handles{};
+    // Bumped before every read; only the newest read of a parameter is published.
+    std::array<std::uint64_t, CachedParameterCount> _generations{};
+
+    // Odd while an update is being published.
+    std::atomic<std::uint64_t> _sequence{0};
+    std::array<std::atomic<double>, CachedParameterCount> _values{};
+    std::array<std::atomic<bool>, CachedParameterCount> _available{};
+};
+
+#endif // PARAMETERCACHE_H
@@ -0,0 +1,322 @@
+#include "ParameterWriter.h"
+#include "ThreadSettings.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+
+namespace {
+
+bool isSelectorNode(GenApi::INode* node)
+{
+    const auto* selector = dynamic_cast<GenApi::ISelector*>(node);
+    return selector && selector->IsSelector();
+}
+
+GenApi::IValue& valueNode(GenApi::INode* node)
+{
+    auto* value = dynamic_cast<GenApi::IValue*>(node);
+    if(!value) throw std::runtime_error("Feature has no value: " + std::string(node->GetName().c_str()));
+    return *value;
+}
+
+void writeValue(GenApi::INode* node, const ParameterWriter::Value& value)
+{
+    std::visit([node](const auto& typed){
+        using T = std::decay_t<decltype(typed)>;
+        if constexpr(std::is_same_v<T, std::string>){
+            valueNode(node).FromString(typed.c_str());
+        }else if constexpr(std::is_same_v<T, bool>){
+            if(auto* boolean = dynamic_cast<GenApi::IBoolean*>(node)){
+                boolean->SetValue(typed);
+            }else{
+                valueNode(node).FromString(typed ? "1" : "0");
+            }
+        }else if constexpr(std::is_same_v<T, std::int64_t>){
+            if(auto* integer = dynamic_cast<GenApi::IInteger*>(node)){
+                integer->SetValue(typed);
+            }else if(auto* floating = dynamic_cast<GenApi::IFloat*>(node)){
+                floating->SetValue(static_cast<double>(typed));
+            }else{
+                valueNode(node).FromString(std::to_string(typed).c_str());
+            }
+        }else{
+            if(auto* floating = dynamic_cast<GenApi::IFloat*>(node)){
+                floating->SetValue(typed);
+            }else if(auto* integer = dynamic_cast<GenApi::IInteger*>(node)){
+                integer->SetValue(std::llround(typed));
+            }else{
+                valueNode(node).FromString(std::to_string(typed).c_str());
+            }
+        }
+    }, value);
+}
+
+}
+
+ParameterWriter::ParameterWriter(NodeMapProvider nodeMapProvider,
+                                 std::string threadName,
+                                 NodeResolver nodeResolver,
+                                 AppliedHook appliedHook)
+    : _nodeMapProvider(std::move(nodeMapProvider))
+    , _nodeResolver(std::move(nodeResolver))
+    , _appliedHook(std::move(appliedHook))
+    , _threadName(std::move(threadName))
+{
+}
+
+ParameterWriter::~ParameterWriter()
+{
+    shutdown();
+}
+
+std::future<ParameterWriteResult> ParameterWriter::write(std::string feature, Value value)
+{
+    std::vector<Operation> operations(1);
+    operations.front().feature = std::move(feature);
+    operations.front().value = std::move(value);
+    auto future = operations.front().promise.emplace().get_future();
+    enqueue(std::move(operations));
+    return future;
+}
+
+void ParameterWriter::write(std::string feature, Value value, Callback callback)
+{
+    std::vector<Operation> operations(1);
+    operations.front().feature = std::move(feature);
+    operations.front().value = std::move(value);
+    operations.front().callback = std::move(callback);
+    enqueue(std::move(operations));
+}
+
+std::vector<std::future<ParameterWriteResult>> ParameterWriter::write(std::vector<std::pair<std::string, Value>> writes)
+{
+    std::vector<Operation> operations(writes.size());
+    std::vector<std::future<ParameterWriteResult>> futures;
+    futures.reserve(writes.size());
+    for(std::size_t index = 0; index < writes.size(); ++index){
+        operations[index].feature = std::move(writes[index].first);
+        operations[index].value = std::move(writes[index].second);
+        futures.push_back(operations[index].promise.emplace().get_future());
+    }
+    enqueue(std::move(operations));
+    return futures;
+}
+
+std::future<ParameterWriteResult> ParameterWriter::execute(std::string command)
+{
+    std::vector<Operation> operations(1);
+    operations.front().feature = std::move(command);
+    auto future = operations.front().promise.emplace().get_future();
+    enqueue(std::move(operations));
+    return future;
+}
+
+void ParameterWriter::execute(std::string command, Callback callback)
+{
+    std::vector<Operation> operations(1);
+    operations.front().feature = std::move(command);
+    operations.front().callback = std::move(callback);
+    enqueue(std::move(operations));
+}
+
+void ParameterWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    if(_thread.get_id() == std::this_thread::get_id()) return;
+    _idle.wait(lock, [this]{ return _pending.empty() && !_busy; });
+}
+
+std::unique_lock<std::mutex> ParameterWriter::suspend()
+{
+    return std::unique_lock<std::mutex>(_applyMutex);
+}
+
+void ParameterWriter::shutdown()
+{
+    std::vector<Operation> abandoned;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+        abandoned.swap(_pending);
+    }
+    _workAvailable.notify_all();
+    if(_thread.joinable()){
+        if(_thread.get_id() == std::this_thread::get_id()){
+            _thread.detach();
+        }else{
+            _thread.join();
+        }
+    }
+
+    ParameterWriteResult result;
+    result.error = "Parameter writer stopped.";
+    for(auto& operation : abandoned){
+        result.feature = operation.feature;
+        complete(operation, result);
+    }
+    _idle.notify_all();
+}
+
+ParameterWriterStatistics ParameterWriter::statistics() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _statistics;
+}
+
+void ParameterWriter::enqueue(std::vector<Operation> operations)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if(!_stopping){
+            _statistics.requested += operations.size();
+            for(auto& operation : operations){
+                _pending.push_back(std::move(operation));
+            }
+            if(!_thread.joinable()){
+                _thread = std::thread([this]{ run(); });
+            }
+            operations.clear();
+        }
+    }
+    _workAvailable.notify_one();
+
+    ParameterWriteResult result;
+    result.error = "Parameter writer stopped.";
+    for(auto& operation : operations){
+        result.feature = operation.feature;
+        complete(operation, result);
+    }
+}
+
+void ParameterWriter::run()
+{
+    applyCurrentThreadSettings({}, _threadName);
+
+    while(true){
+        std::vector<Operation> batch;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _workAvailable.wait(lock, [this]{ return _stopping || !_pending.empty(); });
+            if(_stopping) break;
+            batch.swap(_pending);
+            _busy = true;
+        }
+
+        std::vector<ParameterWriteResult> results;
+        {
+            std::lock_guard<std::mutex> applyLock(_applyMutex);
+            std::vector<GenApi::INode*> applied;
+            results = applyBatch(batch, applied);
+            if(_appliedHook && !applied.empty()){
+                try{
+                    _appliedHook(applied);
+                }catch(...){
+                }
+            }
+        }
+        // Outside the apply lock so a callback may close the camera.
+        for(std::size_t index = 0; index < batch.size(); ++index){
+            complete(batch[index], results[index]);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _busy = false;
+        }
+        _idle.notify_all();
+    }
+}
+
+std::vector<ParameterWriteResult> ParameterWriter::applyBatch(std::vector<Operation>& batch, std::vector<GenApi::INode*>& applied)
+{
+    constexpr auto None = static_cast<std::size_t>(-1);
+    std::vector<ParameterWriteResult> results(batch.size());
+    GenApi::INodeMap* nodeMap = nullptr;
+    std::vector<GenApi::INode*> nodes(batch.size(), nullptr);
+    try{
+        nodeMap = _nodeMapProvider();
+        for(std::size_t index = 0; nodeMap && index < batch.size(); ++index){
+            nodes[index] = _nodeResolver ? _nodeResolver(batch[index].feature) : nullptr;
+            if(!nodes[index]){
+                nodes[index] = nodeMap->GetNode(batch[index].feature.c_str());
+            }
+        }
+    }catch(const GenICam::GenericException&){
+        nodeMap = nullptr;
+    }
+
+    // Walk backwards so every superseded write points at the write that survives.
+    std::vector<std::size_t> survivor(batch.size(), None);
+    std::unordered_map<std::string, std::size_t> latest;
+    for(std::size_t index = batch.size(); index-- > 0;){
+        if(!batch[index].value || isSelectorNode(nodes[index])){
+            latest.clear();
+            continue;
+        }
+        const auto found = latest.find(batch[index].feature);
+        if(found != latest.end()){
+            survivor[index] = found->second;
+        }else{
+            latest.emplace(batch[index].feature, index);
+        }
+    }
+
+    std::uint64_t coalesced = 0;
+    std::uint64_t failed = 0;
+    for(std::size_t index = 0; index < batch.size(); ++index){
+        if(survivor[index] != None) continue;
+        auto& result = results[index];
+        const auto& operation = batch[index];
+        result.feature = operation.feature;
+        if(!nodeMap){
+            result.error = "Camera is not open.";
+        }else if(!nodes[index]){
+            result.error = "Unknown feature: " + operation.feature;
+        }else{
+            try{
+                if(operation.value){
+                    writeValue(nodes[index], *operation.value);
+                }else{
+                    auto* command = dynamic_cast<GenApi::ICommand*>(nodes[index]);
+                    if(!command) throw std::runtime_error("Feature is not a command: " + operation.feature);
+                    command->Execute();
+                }
+                result.success = true;
+                applied.push_back(nodes[index]);
+            }catch(const GenICam::GenericException &e){
+                result.error = e.GetDescription();
+            }catch(const std::exception &e){
+                result.error = e.what();
+            }
+        }
+        if(!result.success) ++failed;
+    }
+    for(std::size_t index = 0; index < batch.size(); ++index){
+        if(survivor[index] == None) continue;
+        results[index] = results[survivor[index]];
+        results[index].coalesced = true;
+        ++coalesced;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_statistics.batches;
+    _statistics.applied += applied.size();
+    _statistics.coalesced += coalesced;
+    _statistics.failed += failed;
+    return results;
+}
+
+void ParameterWriter::complete(Operation& operation, const ParameterWriteResult& result)
+{
+    if(operation.promise){
+        operation.promise->set_value(result);
+    }
+    if(operation.callback){
+        try{
+            operation.callback(result);
+        }catch(...){
+        }
+    }
+}
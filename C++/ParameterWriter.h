@@ -0,0 +1,119 @@
+#ifndef PARAMETERWRITER_H
+#define PARAMETERWRITER_H
+
+/**
+ * @file ParameterWriter.h
+ * @brief Serialized, coalescing parameter writes on one thread per camera.
+ *
+ * Writes are queued and applied by a single writer thread. Each pass takes
+ * every queued operation; a value write that a later write to the same
+ * feature supersedes within that pass is skipped, unless a command or a
+ * selector write lies between them. Superseded writes complete with the
+ * result of the write that replaced them.
+ */
+
+#include <pylon/PylonIncludes.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+struct ParameterWriteResult
+{
+    std::string feature;
+    bool success = false;
+    /** Skipped in favor of a later write to the same feature; the other fields describe that write. */
+    bool coalesced = false;
+    std::string error;
+};
+
+struct ParameterWriterStatistics
+{
+    std::uint64_t requested = 0;
+    /** Writes and commands that reached the device. */
+    std::uint64_t applied = 0;
+    std::uint64_t coalesced = 0;
+    std::uint64_t failed = 0;
+    std::uint64_t batches = 0;
+};
+
+class ParameterWriter
+{
+public:
+    /** Typed values use the matching GenApi interface; strings go through `FromString()`, e.g. enumeration symbolics. */
+    using Value = std::variant<std::int64_t, double, bool, std::string>;
+    using Callback = std::function<void(const ParameterWriteResult& result)>;
+    /** Returns the node map to write to, or null while the camera is not open. */
+    using NodeMapProvider = std::function<GenApi::INodeMap*()>;
+    /** Returns a handle resolved in advance for `feature`, or null to look it up in the node map. */
+    using NodeResolver = std::function<GenApi::INode*(const std::string& feature)>;
+    /** Runs on the writer thread after each pass, before the device can close, with the nodes written or executed. */
+    using AppliedHook = std::function<void(const std::vector<GenApi::INode*>& applied)>;
+
+    ParameterWriter(NodeMapProvider nodeMapProvider,
+                    std::string threadName,
+                    NodeResolver nodeResolver = {},
+                    AppliedHook appliedHook = {});
+    ~ParameterWriter();
+
+    ParameterWriter(const ParameterWriter&) = delete;
+    ParameterWriter& operator=(const ParameterWriter&) = delete;
+
+    std::future<ParameterWriteResult> write(std::string feature, Value value);
+    /** @note `callback` runs on the writer thread. */
+    void write(std::string feature, Value value, Callback callback);
+    /** Queues the writes as one unit so they are applied in order within the same pass. */
+    std::vector<std::future<ParameterWriteResult>> write(std::vector<std::pair<std::string, Value>> writes);
+    std::future<ParameterWriteResult> execute(std::string command);
+    void execute(std::string command, Callback callback);
+
+    /** Blocks until every write queued so far has completed. */
+    void flush();
+    /** Holds off the next pass while the returned lock is held, e.g. while the device is closed. */
+    [[nodiscard]] std::unique_lock<std::mutex> suspend();
+    /** Fails queued writes and joins the thread; later writes fail immediately. */
+    void shutdown();
+
+    [[nodiscard]] ParameterWriterStatistics statistics() const;
+
+private:
+    struct Operation
+    {
+        std::string feature;
+        /** Empty for a command. */
+        std::optional<Value> value;
+        std::optional<std::promise<ParameterWriteResult>> promise;
+        Callback callback;
+    };
+
+    void enqueue(std::vector<Operation> operations);
+    void run();
+    std::vector<ParameterWriteResult> applyBatch(std::vector<Operation>& batch, std::vector<GenApi::INode*>& applied);
+    static void complete(Operation& operation, const ParameterWriteResult& result);
+
+    const NodeMapProvider _nodeMapProvider;
+    const NodeResolver _nodeResolver;
+    const AppliedHook _appliedHook;
+    const std::string _threadName;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _workAvailable;
+    std::condition_variable _idle;
+    std::vector<Operation> _pending;
+    bool _busy = false;
+    bool _stopping = false;
+    ParameterWriterStatistics _statistics;
+    std::thread _thread;
+
+    std::mutex _applyMutex;
+};
+
+#endif // PARAMETERWRITER_H
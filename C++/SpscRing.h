@@ -0,0 +1,81 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+/**
+ * @file SpscRing.h
+ * @brief Bounded lock-free single-producer/single-consumer ring buffer.
+ *
+ * One thread may call `tryPush()` and one other thread may call `tryPop()`
+ * concurrently. Each side caches the opposite index so the common case touches
+ * only its own cache line.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+template<typename T>
+class SpscRing
+{
+public:
+    /** Creates a ring holding at least `capacity` elements, rounded up to a power of two. */
+    explicit SpscRing(const std::size_t capacity)
+    {
+        std::size_t size = 1;
+        while(size < capacity) size <<= 1;
+        _slots.resize(size);
+        _mask = size - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /** Producer side; returns `false` and leaves the ring unchanged when full. */
+    bool tryPush(const T& value)
+    {
+        const auto tail = _tail.load(std::memory_order_relaxed);
+        if(tail - _producerCachedHead == _slots.size()){
+            _producerCachedHead = _head.load(std::memory_order_acquire);
+            if(tail - _producerCachedHead == _slots.size()) return false;
+        }
+        _slots[tail & _mask] = value;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Consumer side; moves the oldest element out and returns `false` when empty. */
+    bool tryPop(T& value)
+    {
+        const auto head = _head.load(std::memory_order_relaxed);
+        if(head == _consumerCachedTail){
+            _consumerCachedTail = _tail.load(std::memory_order_acquire);
+            if(head == _consumerCachedTail) return false;
+        }
+        auto& slot = _slots[head & _mask];
+        value = std::move(slot);
+        slot = T{};
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return _slots.size(); }
+    /** Approximate element count; exact only when both sides are idle. */
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        const auto head = _head.load(std::memory_order_acquire);
+        return _tail.load(std::memory_order_acquire) - head;
+    }
+
+private:
+    static constexpr std::size_t CacheLineSize = 64;
+
+    std::vector<T> _slots;
+    std::size_t _mask = 0;
+    alignas(CacheLineSize) std::atomic<std::size_t> _head{0};
+    std::size_t _consumerCachedTail = 0;
+    alignas(CacheLineSize) std::atomic<std::size_t> _tail{0};
+    std::size_t _producerCachedHead = 0;
+};
+
+#endif // SPSCRING_H
@@ -0,0 +1,112 @@
+/**
+ * @file DeviceTableTest.cpp
+ * @brief Lookups and enumeration diffs of `DeviceTable`.
+ *
+ * Builds `CDeviceInfo` values by hand, so it needs the pylon headers and base
+ * libraries but no camera or transport layer.
+ */
+
+#include "DeviceTable.h"
+#include "TestCheck.h"
+
+#include <memory>
+#include <string>
+
+namespace {
+
+Pylon::CDeviceInfo makeDevice(const char* fullName, const char* friendlyName, const char* serialNumber,
+                              const char* userDefinedName, const char* ipAddress, const char* macAddress)
+{
+    Pylon::CDeviceInfo device;
+    device.SetFullName(fullName);
+    device.SetFriendlyName(friendlyName);
+    device.SetSerialNumber(serialNumber);
+    device.SetUserDefinedName(userDefinedName);
+    if(ipAddress) device.SetIpAddress(ipAddress);
+    if(macAddress) device.SetMacAddress(macAddress);
+    return device;
+}
+
+std::string serialOf(const Pylon::CDeviceInfo* device)
+{
+    return device ? device->GetSerialNumber().c_str() : "";
+}
+
+Pylon::DeviceInfoList_t enumeration()
+{
+    Pylon::DeviceInfoList_t devices;
+    devices.push_back(makeDevice("GigE#A", "Camera A", "100", "left", "192.168.0.10", "00:30:53:1A:2B:3C"));
+    devices.push_back(makeDevice("GigE#B", "Camera B", "200", "left", "192.168.0.11", "0030531a2b3d"));
+    // Its user-defined name equals A's serial number.
+    devices.push_back(makeDevice("Usb#C", "Camera C", "300", "100", nullptr, nullptr));
+    return devices;
+}
+
+void lookups()
+{
+    const DeviceTable table(enumeration(), DeviceTable::Clock::now());
+    CHECK(table.isEnumerated());
+    CHECK_EQUAL(table.devices().size(), 3u);
+
+    CHECK_EQUAL(serialOf(table.find(DeviceKey::FriendlyName, "Camera B")), "200");
+    CHECK_EQUAL(serialOf(table.find(DeviceKey::SerialNumber, "300")), "300");
+    CHECK_EQUAL(serialOf(table.find(DeviceKey::IpAddress, "192.168.0.11")), "200");
+    CHECK(table.find(DeviceKey::SerialNumber, "999") == nullptr);
+    CHECK(table.find(DeviceKey::SerialNumber, "") == nullptr);
+
+    // The first device wins when several share a value.
+    CHECK_EQUAL(serialOf(table.find(DeviceKey::UserDefinedName, "left")), "100");
+    // Keys are tried in DeviceKey order, so a serial number beats a user-defined name.
+    CHECK_EQUAL(serialOf(table.find("100")), "100");
+    CHECK_EQUAL(serialOf(table.find(DeviceKey::UserDefinedName, "100")), "300");
+    CHECK_EQUAL(serialOf(table.find("192.168.0.10")), "100");
+
+    // MAC addresses match regardless of separators and case.
+    CHECK_EQUAL(serialOf(table.find(DeviceKey::MacAddress, "0030531a2b3c")), "100");
+    CHECK_EQUAL(serialOf(table.find(DeviceKey::MacAddress, "00-30-53-1a-2b-3c")), "100");
+    CHECK_EQUAL(serialOf(table.find(DeviceKey::MacAddress, "00:30:53:1A:2B:3D")), "200");
+    CHECK_EQUAL(serialOf(table.find("0030.531A.2B3D")), "200");
+    // Other keys are compared exactly.
+    CHECK(table.find(DeviceKey::FriendlyName, "camera a") == nullptr);
+
+    const DeviceTable empty;
+    CHECK(!empty.isEnumerated());
+    CHECK(empty.age() == DeviceTable::Clock::duration::max());
+    CHECK(empty.find("100") == nullptr);
+}
+
+void diffs()
+{
+    const DeviceTable before(enumeration(), DeviceTable::Clock::now());
+
+    Pylon::DeviceInfoList_t devices;
+    devices.push_back(makeDevice("GigE#A", "Camera A", "100", "left", "192.168.0.10", "00:30:53:1A:2B:3C"));
+    devices.push_back(makeDevice("GigE#B", "Camera B", "200", "left", "192.168.0.21", "0030531a2b3d"));
+    devices.push_back(makeDevice("GigE#D", "Camera D", "400", "right", "192.168.0.12", "0030531a2b3e"));
+    auto after = std::make_shared<const DeviceTable>(std::move(devices), DeviceTable::Clock::now());
+
+    const auto diff = diffDeviceTables(before, after);
+    CHECK(diff.table == after);
+    CHECK(!diff.empty());
+    CHECK_EQUAL(diff.added.size(), 1u);
+    CHECK(!diff.added.empty() && serialOf(&diff.added.front()) == "400");
+    CHECK_EQUAL(diff.removed.size(), 1u);
+    CHECK(!diff.removed.empty() && serialOf(&diff.removed.front()) == "300");
+    // Reports the new info of the device whose IP address changed; A is unchanged.
+    CHECK_EQUAL(diff.changed.size(), 1u);
+    CHECK(!diff.changed.empty() && std::string(diff.changed.front().GetIpAddress().c_str()) == "192.168.0.21");
+
+    const auto same = diffDeviceTables(*after, after);
+    CHECK(same.empty());
+    CHECK(diffDeviceTables(before, nullptr).empty());
+}
+
+}
+
+int main()
+{
+    lookups();
+    diffs();
+    if(testFailures() == 0) std::printf("DeviceTableTest passed\n");
+    return testFailures();
+}
@@ -0,0 +1,133 @@
+/**
+ * @file MetricsRegistryTest.cpp
+ * @brief Histogram buckets, Prometheus text output, and series lifetime of `MetricsRegistry`.
+ *
+ * Pylon-free; uses a local registry so the process-wide one stays untouched.
+ */
+
+#include "MetricsRegistry.h"
+#include "TestCheck.h"
+
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool contains(const std::string& text, const std::string& line)
+{
+    return text.find(line + '\n') != std::string::npos;
+}
+
+// Value of the first line starting with `prefix`, or -1 when there is none.
+long long valueAfter(const std::string& text, const std::string& prefix)
+{
+    std::istringstream lines(text);
+    std::string line;
+    while(std::getline(lines, line)){
+        if(line.compare(0, prefix.size(), prefix) == 0){
+            return std::stoll(line.substr(prefix.size()));
+        }
+    }
+    return -1;
+}
+
+void histogramBuckets()
+{
+    // Unsorted and duplicated bounds are normalized; a value on a bound falls into that bucket.
+    MetricHistogram histogram({0.5, 0.1, 1.0, 0.5});
+    CHECK((histogram.upperBounds() == std::vector<double>{0.1, 0.5, 1.0}));
+    for(const auto value : {0.1, 0.3, 1.0, 5.0}){
+        histogram.observe(value);
+    }
+    CHECK((histogram.cumulativeCounts() == std::vector<std::uint64_t>{1, 2, 3, 4}));
+    CHECK_EQUAL(histogram.count(), 4u);
+    CHECK(histogram.sum() > 6.39 && histogram.sum() < 6.41);
+
+    MetricHistogram unbounded({});
+    unbounded.observe(-1.0);
+    CHECK((unbounded.cumulativeCounts() == std::vector<std::uint64_t>{1}));
+}
+
+void labelEscaping()
+{
+    MetricsRegistry registry;
+    auto counter = registry.counter("camera_test_total", "Help with \\ and\nnewline \"kept\".",
+                                    {{"path", "a\"b\\c\nd"}, {"camera", "1"}});
+    counter->add(3);
+    const auto text = formatPrometheusText(registry.snapshot());
+    CHECK(contains(text, "# HELP camera_test_total Help with \\\\ and\\nnewline \"kept\"."));
+    CHECK(contains(text, "# TYPE camera_test_total counter"));
+    CHECK(contains(text, "camera_test_total{path=\"a\\\"b\\\\c\\nd\",camera=\"1\"} 3"));
+}
+
+void histogramText()
+{
+    MetricsRegistry registry;
+    auto histogram = registry.histogram("camera_test_seconds", "", {0.001, 0.01}, {{"camera", "2"}});
+    for(const auto value : {0.0005, 0.002, 0.5}){
+        histogram->observe(value);
+    }
+    const auto text = formatPrometheusText(registry.snapshot());
+    CHECK(text.find("# HELP camera_test_seconds") == std::string::npos);
+    CHECK(contains(text, "# TYPE camera_test_seconds histogram"));
+    CHECK(contains(text, "camera_test_seconds_bucket{camera=\"2\",le=\"0.001\"} 1"));
+    CHECK(contains(text, "camera_test_seconds_bucket{camera=\"2\",le=\"0.01\"} 2"));
+    CHECK(contains(text, "camera_test_seconds_bucket{camera=\"2\",le=\"+Inf\"} 3"));
+    CHECK(contains(text, "camera_test_seconds_count{camera=\"2\"} 3"));
+    CHECK(text.find("camera_test_seconds_sum{camera=\"2\"} 0.5025") != std::string::npos);
+    CHECK_EQUAL(valueAfter(text, "camera_test_seconds_bucket{camera=\"2\",le=\"+Inf\"} "),
+                valueAfter(text, "camera_test_seconds_count{camera=\"2\"} "));
+}
+
+void releasedSeries()
+{
+    MetricsRegistry registry;
+    auto first = registry.gauge("camera_test_gauge", "Gauge.", {{"camera", "1"}});
+    auto second = registry.gauge("camera_test_gauge", "Gauge.", {{"camera", "2"}});
+    CHECK(registry.gauge("camera_test_gauge", "Gauge.", {{"camera", "1"}}) == first);
+    first->set(1.5);
+    second->set(2.0);
+
+    first.reset();
+    auto snapshot = registry.snapshot();
+    CHECK(snapshot.find("camera_test_gauge", {{"camera", "1"}}) == nullptr);
+    CHECK(snapshot.find("camera_test_gauge", {{"camera", "2"}}) != nullptr);
+    auto text = formatPrometheusText(snapshot);
+    CHECK(text.find("camera=\"1\"") == std::string::npos);
+    CHECK(contains(text, "camera_test_gauge{camera=\"2\"} 2"));
+
+    // A family without live series disappears, HELP and TYPE lines included.
+    second.reset();
+    snapshot = registry.snapshot();
+    CHECK(snapshot.find("camera_test_gauge") == nullptr);
+    CHECK(formatPrometheusText(snapshot).empty());
+}
+
+void typeMismatch()
+{
+    MetricsRegistry registry;
+    const auto counter = registry.counter("camera_test_events", "Events.");
+    bool threw = false;
+    try{
+        registry.gauge("camera_test_events", "Events.");
+    }catch(const std::invalid_argument&){
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+}
+
+int main()
+{
+    histogramBuckets();
+    labelEscaping();
+    histogramText();
+    releasedSeries();
+    typeMismatch();
+    if(testFailures() == 0) std::printf("MetricsRegistryTest passed\n");
+    return testFailures();
+}
@@ -0,0 +1,36 @@
+#ifndef TESTCHECK_H
+#define TESTCHECK_H
+
+/**
+ * @file TestCheck.h
+ * @brief Minimal assertion macros for the unit test executables; no camera is needed.
+ *
+ * A failed check prints its location and expression and is counted; `main()`
+ * returns `testFailures()` so CTest reports the executable as failed.
+ */
+
+#include <cstdio>
+
+inline int& testFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition) \
+    do{ \
+        if(!(condition)){ \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            ++testFailures(); \
+        } \
+    }while(false)
+
+#define CHECK_EQUAL(actual, expected) \
+    do{ \
+        if(!((actual) == (expected))){ \
+            std::fprintf(stderr, "%s:%d: CHECK_EQUAL(%s, %s) failed\n", __FILE__, __LINE__, #actual, #expected); \
+            ++testFailures(); \
+        } \
+    }while(false)
+
+#endif // TESTCHECK_H
@@ -0,0 +1,130 @@
+#include "ThreadSettings.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+#ifdef _WIN32
+
+bool applyName(const std::string& name, std::string& error)
+{
+    const std::wstring wideName(name.begin(), name.end());
+    const auto result = SetThreadDescription(GetCurrentThread(), wideName.c_str());
+    if(FAILED(result)){
+        error = "SetThreadDescription failed";
+        return false;
+    }
+    return true;
+}
+
+bool applyAffinity(const std::vector<int>& cpus, std::string& error)
+{
+    DWORD_PTR mask = 0;
+    for(const int cpu : cpus){
+        if(cpu < 0 || cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8)){
+            error = "CPU index out of range: " + std::to_string(cpu);
+            return false;
+        }
+        mask |= DWORD_PTR(1) << cpu;
+    }
+    if(SetThreadAffinityMask(GetCurrentThread(), mask) == 0){
+        error = "SetThreadAffinityMask failed: " + std::to_string(GetLastError());
+        return false;
+    }
+    return true;
+}
+
+bool applyScheduling(const ThreadSettings& settings, std::string& error)
+{
+    if(!SetThreadPriority(GetCurrentThread(), settings.priority)){
+        error = "SetThreadPriority failed: " + std::to_string(GetLastError());
+        return false;
+    }
+    return true;
+}
+
+#else
+
+bool applyName(const std::string& name, std::string& error)
+{
+#if defined(__APPLE__)
+    const auto result = pthread_setname_np(name.substr(0, 63).c_str());
+#else
+    const auto result = pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#endif
+    if(result != 0){
+        error = std::string("pthread_setname_np failed: ") + std::strerror(result);
+        return false;
+    }
+    return true;
+}
+
+bool applyAffinity(const std::vector<int>& cpus, std::string& error)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(const int cpu : cpus){
+        if(cpu < 0 || cpu >= CPU_SETSIZE){
+            error = "CPU index out of range: " + std::to_string(cpu);
+            return false;
+        }
+        CPU_SET(cpu, &set);
+    }
+    const auto result = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if(result != 0){
+        error = std::string("pthread_setaffinity_np failed: ") + std::strerror(result);
+        return false;
+    }
+    return true;
+#else
+    (void)cpus;
+    error = "CPU affinity is not supported on this platform";
+    return false;
+#endif
+}
+
+bool applyScheduling(const ThreadSettings& settings, std::string& error)
+{
+    const int policy = settings.scheduling == ThreadSettings::Scheduling::Fifo ? SCHED_FIFO : SCHED_RR;
+    sched_param parameters{};
+    parameters.sched_priority = settings.priority;
+    const auto result = pthread_setschedparam(pthread_self(), policy, &parameters);
+    if(result != 0){
+        error = std::string("pthread_setschedparam failed: ") + std::strerror(result);
+        return false;
+    }
+    return true;
+}
+
+#endif
+
+}
+
+ThreadSettingsReport applyCurrentThreadSettings(const ThreadSettings& settings, const std::string& defaultName)
+{
+    ThreadSettingsReport report;
+    report.name = settings.name.empty() ? defaultName : settings.name;
+
+    std::string error;
+    if(!report.name.empty()){
+        report.nameApplied = applyName(report.name, error);
+        if(!report.nameApplied) report.errors.push_back(error);
+    }
+    if(!settings.cpuAffinity.empty()){
+        report.affinityApplied = applyAffinity(settings.cpuAffinity, error);
+        if(!report.affinityApplied) report.errors.push_back(error);
+    }
+    if(settings.scheduling != ThreadSettings::Scheduling::Default){
+        report.schedulingApplied = applyScheduling(settings, error);
+        if(!report.schedulingApplied) report.errors.push_back(error);
+    }
+    return report;
+}
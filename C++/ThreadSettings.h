@@ -0,0 +1,53 @@
+#ifndef THREADSETTINGS_H
+#define THREADSETTINGS_H
+
+/**
+ * @file ThreadSettings.h
+ * @brief Name, CPU affinity, and scheduling settings for Camera-owned threads.
+ *
+ * Settings are applied by the thread itself when it starts. Each setting is
+ * best effort: failures, such as missing real-time privileges, are reported
+ * back instead of stopping acquisition.
+ */
+
+#include <string>
+#include <vector>
+
+struct ThreadSettings
+{
+    enum class Scheduling
+    {
+        /** Leaves the operating-system default policy unchanged. */
+        Default,
+        /** `SCHED_FIFO` on POSIX; a raised thread priority on Windows. */
+        Fifo,
+        /** `SCHED_RR` on POSIX; a raised thread priority on Windows. */
+        RoundRobin
+    };
+
+    /** Thread name; empty uses the owner's default. Linux truncates names to 15 characters. */
+    std::string name;
+    /** Logical CPUs the thread may run on; empty leaves the affinity unchanged. */
+    std::vector<int> cpuAffinity;
+    Scheduling scheduling = Scheduling::Default;
+    /** POSIX real-time priority, or a Windows `THREAD_PRIORITY_*` level. */
+    int priority = 0;
+};
+
+struct ThreadSettingsReport
+{
+    std::string name;
+    bool nameApplied = false;
+    bool affinityApplied = false;
+    bool schedulingApplied = false;
+    /** One entry per setting that could not be applied. */
+    std::vector<std::string> errors;
+};
+
+/**
+ * @brief Applies `settings` to the calling thread.
+ * @param defaultName Name used when `settings.name` is empty.
+ */
+ThreadSettingsReport applyCurrentThreadSettings(const ThreadSettings& settings, const std::string& defaultName);
+
+#endif // THREADSETTINGS_H
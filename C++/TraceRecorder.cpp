@@ -0,0 +1,248 @@
+#include "TraceRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::string currentThreadName()
+{
+#if defined(__linux__)
+    char name[16] = {};
+    if(pthread_getname_np(pthread_self(), name, sizeof(name)) == 0 && name[0] != '\0'){
+        return name;
+    }
+#endif
+    return {};
+}
+
+void appendJsonString(std::string& json, const char* value)
+{
+    json += '"';
+    for(const char* c = value; c && *c; ++c){
+        const auto ch = static_cast<unsigned char>(*c);
+        if(ch == '"' || ch == '\\'){
+            json += '\\';
+            json += static_cast<char>(ch);
+        }else if(ch < 0x20){
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", ch);
+            json += escaped;
+        }else{
+            json += static_cast<char>(ch);
+        }
+    }
+    json += '"';
+}
+
+// Chrome trace timestamps are microseconds; keep nanosecond precision in the fraction.
+void appendMicroseconds(std::string& json, const std::int64_t nanoseconds)
+{
+    char text[32];
+    const auto sign = nanoseconds < 0 ? "-" : "";
+    const auto magnitude = nanoseconds < 0 ? -nanoseconds : nanoseconds;
+    std::snprintf(text, sizeof(text), "%s%" PRId64 ".%03" PRId64, sign, magnitude / 1000, magnitude % 1000);
+    json += text;
+}
+
+}
+
+TraceRecorder::ThreadBuffer::ThreadBuffer(const std::size_t capacity, const std::uint32_t threadId, std::string threadName)
+    : threadId(threadId)
+    , threadName(std::move(threadName))
+{
+    std::size_t size = 2;
+    while(size < capacity) size <<= 1;
+    slots = std::make_unique<Slot[]>(size);
+    mask = size - 1;
+}
+
+TraceRecorder& TraceRecorder::instance()
+{
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+void TraceRecorder::setThreadCapacity(const std::size_t events)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _threadCapacity = std::max<std::size_t>(2, events);
+}
+
+std::int64_t TraceRecorder::now() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+TraceRecorder::ThreadBuffer& TraceRecorder::currentBuffer()
+{
+    // Keeps the ring alive for dumps after the thread exits and marks it released.
+    thread_local struct Handle
+    {
+        std::shared_ptr<ThreadBuffer> buffer;
+        ~Handle()
+        {
+            if(buffer) buffer->exited.store(true, std::memory_order_relaxed);
+        }
+    } handle;
+
+    if(!handle.buffer){
+        auto name = currentThreadName();
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto threadId = _nextThreadId++;
+        if(name.empty()) name = "thread " + std::to_string(threadId);
+        handle.buffer = std::make_shared<ThreadBuffer>(_threadCapacity, threadId, std::move(name));
+        releaseExitedBuffersLocked(RetainedExitedThreads);
+        _buffers.push_back(handle.buffer);
+    }
+    return *handle.buffer;
+}
+
+void TraceRecorder::releaseExitedBuffersLocked(const std::size_t retained)
+{
+    // Oldest first: _buffers is in registration order.
+    auto exited = static_cast<std::size_t>(std::count_if(_buffers.begin(), _buffers.end(),
+        [](const std::shared_ptr<ThreadBuffer>& buffer){ return buffer->exited.load(std::memory_order_relaxed); }));
+    for(auto iter = _buffers.begin(); iter != _buffers.end() && exited > retained;){
+        if((*iter)->exited.load(std::memory_order_relaxed)){
+            iter = _buffers.erase(iter);
+            --exited;
+        }else{
+            ++iter;
+        }
+    }
+}
+
+void TraceRecorder::record(const char* name, const std::int64_t startNs, const std::int64_t endNs,
+                           const char* argumentName, const std::uint64_t argument) noexcept
+{
+    try{
+        auto& buffer = currentBuffer();
+        const auto position = buffer.written.load(std::memory_order_relaxed);
+        auto& slot = buffer.slots[position & buffer.mask];
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.argumentName.store(argumentName, std::memory_order_relaxed);
+        slot.startNs.store(startNs, std::memory_order_relaxed);
+        slot.durationNs.store(std::max<std::int64_t>(0, endNs - startNs), std::memory_order_relaxed);
+        slot.argument.store(argument, std::memory_order_relaxed);
+        buffer.written.store(position + 1, std::memory_order_release);
+    }catch(...){
+        // Only the first event of a thread allocates; losing it is preferable to throwing from a hot path.
+    }
+}
+
+std::string TraceRecorder::chromeJson() const
+{
+    struct Event
+    {
+        const char* name;
+        const char* argumentName;
+        std::int64_t startNs;
+        std::int64_t durationNs;
+        std::uint64_t argument;
+    };
+
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        buffers = _buffers;
+    }
+    const auto clearedNs = _clearedNs.load(std::memory_order_relaxed);
+#if defined(__linux__)
+    const auto processId = static_cast<long long>(::getpid());
+#else
+    const long long processId = 1;
+#endif
+    const auto pid = std::to_string(processId);
+
+    std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    const auto separator = [&json, &first]{
+        if(!first) json += ",\n";
+        first = false;
+    };
+
+    std::vector<Event> events;
+    for(const auto& buffer : buffers){
+        const auto capacity = buffer->mask + 1;
+        const auto written = buffer->written.load(std::memory_order_acquire);
+        const auto begin = written > capacity ? written - capacity : 0;
+        events.clear();
+        events.reserve(static_cast<std::size_t>(written - begin));
+        for(auto position = begin; position < written; ++position){
+            const auto& slot = buffer->slots[position & buffer->mask];
+            events.push_back({slot.name.load(std::memory_order_relaxed),
+                              slot.argumentName.load(std::memory_order_relaxed),
+                              slot.startNs.load(std::memory_order_relaxed),
+                              slot.durationNs.load(std::memory_order_relaxed),
+                              slot.argument.load(std::memory_order_relaxed)});
+        }
+        // Slots the owner may have reused while they were copied are discarded.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const auto after = buffer->written.load(std::memory_order_relaxed);
+        const auto firstValid = after + 1 > capacity ? after + 1 - capacity : 0;
+        const auto skip = static_cast<std::size_t>(std::min(written, std::max(begin, firstValid)) - begin);
+
+        const auto tid = std::to_string(buffer->threadId);
+        separator();
+        json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":" + tid + ",\"args\":{\"name\":";
+        appendJsonString(json, buffer->threadName.c_str());
+        json += "}}";
+        for(std::size_t index = skip; index < events.size(); ++index){
+            const auto& event = events[index];
+            if(!event.name || event.startNs < clearedNs) continue;
+            separator();
+            json += "{\"name\":";
+            appendJsonString(json, event.name);
+            json += ",\"cat\":\"camera\",\"ph\":\"X\",\"pid\":" + pid + ",\"tid\":" + tid + ",\"ts\":";
+            appendMicroseconds(json, event.startNs);
+            json += ",\"dur\":";
+            appendMicroseconds(json, event.durationNs);
+            if(event.argumentName){
+                json += ",\"args\":{";
+                appendJsonString(json, event.argumentName);
+                json += ':' + std::to_string(event.argument) + '}';
+            }
+            json += '}';
+        }
+    }
+    json += "]}\n";
+    return json;
+}
+
+bool TraceRecorder::writeChromeJson(const std::string& path) const
+{
+    namespace fs = std::filesystem;
+    std::error_code error;
+    const fs::path temporary(path + ".tmp");
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if(!file) return false;
+        file << chromeJson();
+        if(!file.flush()) return false;
+    }
+    fs::rename(temporary, fs::path(path), error);
+    if(error){
+        fs::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+void TraceRecorder::clear()
+{
+    _clearedNs.store(now(), std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(_mutex);
+    releaseExitedBuffersLocked(0);
+}
@@ -0,0 +1,153 @@
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+/**
+ * @file TraceRecorder.h
+ * @brief In-process timeline of acquisition work, exported as Chrome/Perfetto JSON.
+ *
+ * Every thread records complete events (name, start, duration, optional
+ * argument) into its own fixed-size ring, so recording takes no lock and the
+ * oldest events are overwritten when a ring wraps. The `CAMERA_TRACE_*`
+ * macros compile to nothing unless the library is built with
+ * `CAMERA_ENABLE_TRACING`, and record nothing until `setEnabled(true)`.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifndef CAMERA_ENABLE_TRACING
+#define CAMERA_ENABLE_TRACING 0
+#endif
+
+class TraceRecorder
+{
+public:
+    /** Built with `CAMERA_ENABLE_TRACING`; when `false`, the macros record nothing. */
+    static constexpr bool CompiledIn = CAMERA_ENABLE_TRACING != 0;
+    static constexpr std::size_t DefaultThreadCapacity = 16384;
+    /** Rings of exited threads kept for dumps; older ones are released when a new thread starts recording. */
+    static constexpr std::size_t RetainedExitedThreads = 16;
+
+    static TraceRecorder& instance();
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    [[nodiscard]] bool enabled() const noexcept { return _enabled.load(std::memory_order_relaxed); }
+    void setEnabled(bool enabled) noexcept { _enabled.store(enabled, std::memory_order_relaxed); }
+
+    /** Ring size in events for threads that record their first event after the call. */
+    void setThreadCapacity(std::size_t events);
+
+    /** Timestamp in nanoseconds; the same time base as `FrameTiming::now()`. */
+    static std::int64_t now() noexcept;
+
+    /**
+     * @brief Records one complete event on the calling thread's ring.
+     * @param name Must outlive the recorder, e.g. a string literal.
+     * @param argumentName Null for no argument; otherwise also a literal.
+     */
+    void record(const char* name, std::int64_t startNs, std::int64_t endNs,
+                const char* argumentName = nullptr, std::uint64_t argument = 0) noexcept;
+
+    /** Events still held by the rings in the Chrome trace-event JSON format, loadable in Perfetto and chrome://tracing. */
+    [[nodiscard]] std::string chromeJson() const;
+    bool writeChromeJson(const std::string& path) const;
+    /** Hides everything recorded so far from later dumps and releases the rings of exited threads. */
+    void clear();
+
+private:
+    struct Slot
+    {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<const char*> argumentName{nullptr};
+        std::atomic<std::int64_t> startNs{0};
+        std::atomic<std::int64_t> durationNs{0};
+        std::atomic<std::uint64_t> argument{0};
+    };
+
+    // Written by its owning thread only; dumps read it concurrently.
+    struct ThreadBuffer
+    {
+        ThreadBuffer(std::size_t capacity, std::uint32_t threadId, std::string threadName);
+
+        std::unique_ptr<Slot[]> slots;
+        std::size_t mask = 0;
+        std::atomic<std::uint64_t> written{0};
+        const std::uint32_t threadId;
+        const std::string threadName;
+        std::atomic<bool> exited{false};
+    };
+
+    TraceRecorder() = default;
+
+    ThreadBuffer& currentBuffer();
+    /** Drops the oldest rings of exited threads until at most `retained` remain. */
+    void releaseExitedBuffersLocked(std::size_t retained);
+
+    std::atomic<bool> _enabled{false};
+    std::atomic<std::int64_t> _clearedNs{0};
+
+    mutable std::mutex _mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> _buffers;
+    std::size_t _threadCapacity = DefaultThreadCapacity;
+    std::uint32_t _nextThreadId = 1;
+};
+
+/** Records the lifetime of the scope when tracing was enabled at construction. */
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* name, const char* argumentName = nullptr, const std::uint64_t argument = 0) noexcept
+        : _name(name)
+        , _argumentName(argumentName)
+        , _argument(argument)
+        , _startNs(TraceRecorder::instance().enabled() ? TraceRecorder::now() : -1)
+    {
+    }
+
+    ~TraceScope()
+    {
+        if(_startNs >= 0){
+            TraceRecorder::instance().record(_name, _startNs, TraceRecorder::now(), _argumentName, _argument);
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* const _name;
+    const char* const _argumentName;
+    const std::uint64_t _argument;
+    const std::int64_t _startNs;
+};
+
+#define CAMERA_TRACE_CONCAT_INNER(a, b) a##b
+#define CAMERA_TRACE_CONCAT(a, b) CAMERA_TRACE_CONCAT_INNER(a, b)
+
+#if CAMERA_ENABLE_TRACING
+#define CAMERA_TRACE_SCOPE(name) \
+    ::TraceScope CAMERA_TRACE_CONCAT(cameraTraceScope_, __COUNTER__)(name)
+#define CAMERA_TRACE_SCOPE_ARG(name, argumentName, argument) \
+    ::TraceScope CAMERA_TRACE_CONCAT(cameraTraceScope_, __COUNTER__)(name, argumentName, static_cast<std::uint64_t>(argument))
+/** Records an event whose start and end the caller already measured with `TraceRecorder::now()`. */
+#define CAMERA_TRACE_EVENT(name, startNs, endNs, argumentName, argument) \
+    do{ \
+        auto& cameraTraceRecorder_ = ::TraceRecorder::instance(); \
+        if(cameraTraceRecorder_.enabled()){ \
+            cameraTraceRecorder_.record((name), (startNs), (endNs), (argumentName), static_cast<std::uint64_t>(argument)); \
+        } \
+    }while(false)
+#else
+#define CAMERA_TRACE_SCOPE(name) do{}while(false)
+#define CAMERA_TRACE_SCOPE_ARG(name, argumentName, argument) do{}while(false)
+#define CAMERA_TRACE_EVENT(name, startNs, endNs, argumentName, argument) do{}while(false)
+#endif
+
+#endif // TRACERECORDER_H
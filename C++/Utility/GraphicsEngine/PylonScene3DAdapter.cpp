@@ -1,4 +1,5 @@
 #include "PylonScene3DAdapter.h"
+#include "TraceRecorder.h"
 
 #include <QImage>
 
@@ -484,6 +485,7 @@ std::optional<GraphicsScene3D> PylonScene3DAdapter::convert(
     const GraphicsScene3DRequest& request,
     const PylonScene3DProfile& profile) const
 {
+    CAMERA_TRACE_SCOPE("PylonScene3DAdapter::convert");
     switch (profile.family)
     {
     case PylonScene3DProfile::DeviceFamily::Blaze:
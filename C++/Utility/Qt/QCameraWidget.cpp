@@ -271,14 +271,6 @@ void QCameraWidget::prepareForShutdown()
         _refreshThread = nullptr;
     }
 
-    const auto parameterThreads = _parameterThreads;
-    for(QThread* worker : parameterThreads){
-        if(worker){
-            worker->wait();
-        }
-    }
-    _parameterThreads.clear();
-
     if(_camera){
         if(_statusCallbackId != 0){
             _camera->deregisterStatusCallback(_statusCallbackId);
@@ -798,40 +790,28 @@ QWidget *QCameraWidget::createNodeWidget(GenApi::INode *node)
             qWarning() << e.GetDescription() << node->GetName().c_str();
         }
         connect(spinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, [=](int value){
-            spinBox->setEnabled(false);
-            auto* errorMsg = new QString();
-            runAsyncWrite(
-                [=]() {
-                    auto* currentNode = resolveNode(nodeName);
-                    if(!currentNode) return false;
-                    try {
-                        GenApi::CIntegerPtr ptr = currentNode;
-                        ptr->SetValue(value);
-                        return true;
-                    } catch(const Pylon::GenericException &e) {
-                        *errorMsg = QString::fromStdString(e.GetDescription());
-                        return false;
-                    }
-                },
-                [=](bool success) {
-                    spinBox->setEnabled(true);
+            // The spin box stays enabled: held arrows and wheel steps collapse in the parameter writer.
+            const QPointer<QSpinBox> editor(spinBox);
+            runParameterWrite(nodeName, ParameterWriter::Value(static_cast<std::int64_t>(value)),
+                [=](bool success, const QString& errorMsg) {
+                    // A features rebuild may have deleted the editor while the write was queued.
+                    if (!editor) return;
                     if (!success) {
-                        QSignalBlocker block(spinBox);
+                        QSignalBlocker block(editor);
                         auto* currentNode = resolveNode(nodeName);
                         if (currentNode) {
                             try {
                                 GenApi::CIntegerPtr ptr = currentNode;
                                 if (GenApi::IsReadable(ptr)) {
-                                    spinBox->setValue(ptr->GetValue());
+                                    editor->setValue(ptr->GetValue());
                                 }
                             } catch(...) {}
                         }
-                        showStatusMessage(tr("Failed to update '%1': %2").arg(nodeName).arg(*errorMsg), true, 5000);
+                        showStatusMessage(tr("Failed to update '%1': %2").arg(nodeName).arg(errorMsg), true, 5000);
                     } else {
                         showStatusMessage(tr("Parameter '%1' updated to %2.").arg(nodeName).arg(value), false, 3000);
                         scheduleFeaturesRebuild();
                     }
-                    delete errorMsg;
                 }
             );
         });
@@ -850,40 +830,27 @@ QWidget *QCameraWidget::createNodeWidget(GenApi::INode *node)
             qWarning() << e.GetDescription() << node->GetName().c_str() << "Float";
         }
         connect(spinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, [=](double value){
-            spinBox->setEnabled(false);
-            auto* errorMsg = new QString();
-            runAsyncWrite(
-                [=]() {
-                    auto* currentNode = resolveNode(nodeName);
-                    if(!currentNode) return false;
-                    try {
-                        GenApi::CFloatPtr ptr = currentNode;
-                        ptr->SetValue(value);
-                        return true;
-                    } catch(const Pylon::GenericException &e) {
-                        *errorMsg = QString::fromStdString(e.GetDescription());
-                        return false;
-                    }
-                },
-                [=](bool success) {
-                    spinBox->setEnabled(true);
+            // The spin box stays enabled: held arrows and wheel steps collapse in the parameter writer.
+            const QPointer<QDoubleSpinBox> editor(spinBox);
+            runParameterWrite(nodeName, ParameterWriter::Value(value),
+                [=](bool success, const QString& errorMsg) {
+                    if (!editor) return;
                     if (!success) {
-                        QSignalBlocker block(spinBox);
+                        QSignalBlocker block(editor);
                         auto* currentNode = resolveNode(nodeName);
                         if (currentNode) {
                             try {
                                 GenApi::CFloatPtr ptr = currentNode;
                                 if (GenApi::IsReadable(ptr)) {
-                                    spinBox->setValue(ptr->GetValue());
+                                    editor->setValue(ptr->GetValue());
                                 }
                             } catch(...) {}
                         }
-                        showStatusMessage(tr("Failed to update '%1': %2").arg(nodeName).arg(*errorMsg), true, 5000);
+                        showStatusMessage(tr("Failed to update '%1': %2").arg(nodeName).arg(errorMsg), true, 5000);
                     } else {
                         showStatusMessage(tr("Parameter '%1' updated to %2.").arg(nodeName).arg(value), false, 3000);
                         scheduleFeaturesRebuild();
                     }
-                    delete errorMsg;
                 }
             );
         });
@@ -902,39 +869,27 @@ QWidget *QCameraWidget::createNodeWidget(GenApi::INode *node)
         const auto updateBooleanNode = [=](const Qt::CheckState state){
             checkBox->setEnabled(false);
             bool val = (state == Qt::Checked) ? true : false;
-            auto* errorMsg = new QString();
-            runAsyncWrite(
-                [=]() {
-                    auto* currentNode = resolveNode(nodeName);
-                    if(!currentNode) return false;
-                    try {
-                        GenApi::CBooleanPtr ptr = currentNode;
-                        ptr->SetValue(val);
-                        return true;
-                    } catch(const Pylon::GenericException &e) {
-                        *errorMsg = QString::fromStdString(e.GetDescription());
-                        return false;
-                    }
-                },
-                [=](bool success) {
-                    checkBox->setEnabled(true);
+            const QPointer<QCheckBox> editor(checkBox);
+            runParameterWrite(nodeName, ParameterWriter::Value(val),
+                [=](bool success, const QString& errorMsg) {
+                    if (!editor) return;
+                    editor->setEnabled(true);
                     if (!success) {
-                        QSignalBlocker block(checkBox);
+                        QSignalBlocker block(editor);
                         auto* currentNode = resolveNode(nodeName);
                         if (currentNode) {
                             try {
                                 GenApi::CBooleanPtr ptr = currentNode;
                                 if (GenApi::IsReadable(ptr)) {
-                                    checkBox->setChecked(ptr->GetValue());
+                                    editor->setChecked(ptr->GetValue());
                                 }
                             } catch(...) {}
                         }
-                        showStatusMessage(tr("Failed to update '%1': %2").arg(nodeName).arg(*errorMsg), true, 5000);
+                        showStatusMessage(tr("Failed to update '%1': %2").arg(nodeName).arg(errorMsg), true, 5000);
                     } else {
                         showStatusMessage(tr("Parameter '%1' updated to %2.").arg(nodeName).arg(val ? "True" : "False"), false, 3000);
                         scheduleFeaturesRebuild();
                     }
-                    delete errorMsg;
                 }
             );
         };
@@ -961,39 +916,27 @@ QWidget *QCameraWidget::createNodeWidget(GenApi::INode *node)
         connect(lineEdit, &QLineEdit::editingFinished, this, [=](){
             lineEdit->setEnabled(false);
             QString text = lineEdit->text();
-            auto* errorMsg = new QString();
-            runAsyncWrite(
-                [=]() {
-                    auto* currentNode = resolveNode(nodeName);
-                    if(!currentNode) return false;
-                    try {
-                        GenApi::CStringPtr ptr = currentNode;
-                        ptr->SetValue(text.toStdString().c_str());
-                        return true;
-                    } catch(const Pylon::GenericException &e) {
-                        *errorMsg = QString::fromStdString(e.GetDescription());
-                        return false;
-                    }
-                },
-                [=](bool success) {
-                    lineEdit->setEnabled(true);
+            const QPointer<QLineEdit> editor(lineEdit);
+            runParameterWrite(nodeName, ParameterWriter::Value(text.toStdString()),
+                [=](bool success, const QString& errorMsg) {
+                    if (!editor) return;
+                    editor->setEnabled(true);
                     if (!success) {
-                        QSignalBlocker block(lineEdit);
+                        QSignalBlocker block(editor);
                         auto* currentNode = resolveNode(nodeName);
                         if (currentNode) {
                             try {
                                 GenApi::CStringPtr ptr = currentNode;
                                 if (GenApi::IsReadable(ptr)) {
-                                    lineEdit->setText(ptr->GetValue().c_str());
+                                    editor->setText(ptr->GetValue().c_str());
                                 }
                             } catch(...) {}
                         }
-                        showStatusMessage(tr("Failed to update '%1': %2").arg(nodeName).arg(*errorMsg), true, 5000);
+                        showStatusMessage(tr("Failed to update '%1': %2").arg(nodeName).arg(errorMsg), true, 5000);
                     } else {
                         showStatusMessage(tr("Parameter '%1' updated to '%2'.").arg(nodeName).arg(text), false, 3000);
                         scheduleFeaturesRebuild();
                     }
-                    delete errorMsg;
                 }
             );
         });
@@ -1024,41 +967,28 @@ QWidget *QCameraWidget::createNodeWidget(GenApi::INode *node)
         }
         connect(comboBox, &QComboBox::currentTextChanged, this, [=](QString text){
             comboBox->setEnabled(false);
-            auto* errorMsg = new QString();
             QString comboData = comboBox->currentData().toString();
-            runAsyncWrite(
-                [=]() {
-                    auto* currentNode = resolveNode(nodeName);
-                    if(!currentNode) return false;
-                    try {
-                        GenApi::CEnumerationPtr ptr = currentNode;
-                        auto val = ptr->GetEntryByName(comboData.toStdString().c_str());
-                        ptr->SetIntValue(val->GetNumericValue());
-                        return true;
-                    } catch(const Pylon::GenericException &e) {
-                        *errorMsg = QString::fromStdString(e.GetDescription());
-                        return false;
-                    }
-                },
-                [=](bool success) {
-                    comboBox->setEnabled(true);
+            const QPointer<QComboBox> editor(comboBox);
+            runParameterWrite(nodeName, ParameterWriter::Value(comboData.toStdString()),
+                [=](bool success, const QString& errorMsg) {
+                    if (!editor) return;
+                    editor->setEnabled(true);
                     if (!success) {
-                        QSignalBlocker block(comboBox);
+                        QSignalBlocker block(editor);
                         auto* currentNode = resolveNode(nodeName);
                         if (currentNode) {
                             try {
                                 GenApi::CEnumerationPtr ptr = currentNode;
                                 if (GenApi::IsReadable(ptr) && ptr->GetCurrentEntry()) {
-                                    comboBox->setCurrentText(ptr->GetCurrentEntry()->GetNode()->GetDisplayName().c_str());
+                                    editor->setCurrentText(ptr->GetCurrentEntry()->GetNode()->GetDisplayName().c_str());
                                 }
                             } catch(...) {}
                         }
-                        showStatusMessage(tr("Failed to update '%1': %2").arg(nodeName).arg(*errorMsg), true, 5000);
+                        showStatusMessage(tr("Failed to update '%1': %2").arg(nodeName).arg(errorMsg), true, 5000);
                     } else {
                         showStatusMessage(tr("Parameter '%1' updated to '%2'.").arg(nodeName).arg(text), false, 3000);
                         scheduleFeaturesRebuild();
                     }
-                    delete errorMsg;
                 }
             );
         });
@@ -1069,39 +999,22 @@ QWidget *QCameraWidget::createNodeWidget(GenApi::INode *node)
         widget = button;
         connect(button, &QPushButton::clicked, this, [=]{
             button->setEnabled(false);
-            auto* errorMsg = new QString();
             showStatusMessage(tr("Executing command '%1'...").arg(nodeName), false, 0);
             
-            runAsyncWrite(
-                [=]() {
-                    auto* currentNode = resolveNode(nodeName);
-                    if(!currentNode) return false;
-                    try {
-                        GenApi::CCommandPtr ptr = currentNode;
-                        if(!GenApi::IsWritable(ptr)) return false;
-                        ptr->Execute();
-                        return true;
-                    } catch(const Pylon::GenericException &e) {
-                        *errorMsg = QString::fromStdString(e.GetDescription());
-                        return false;
-                    } catch(const std::exception &e) {
-                        *errorMsg = QString::fromStdString(e.what());
-                        return false;
-                    }
-                },
-                [=](bool success) {
-                    button->setEnabled(true);
+            const QPointer<QPushButton> editor(button);
+            runParameterWrite(nodeName, std::nullopt,
+                [=](bool success, const QString& errorMsg) {
+                    if (editor) editor->setEnabled(true);
                     scheduleFeaturesRebuild();
                     if (!success) {
-                        if (errorMsg->isEmpty()) {
+                        if (errorMsg.isEmpty()) {
                             showStatusMessage(tr("Failed to execute command '%1'.").arg(nodeName), true, 5000);
                         } else {
-                            showStatusMessage(tr("Failed to execute command '%1': %2").arg(nodeName).arg(*errorMsg), true, 5000);
+                            showStatusMessage(tr("Failed to execute command '%1': %2").arg(nodeName).arg(errorMsg), true, 5000);
                         }
                     } else {
                         showStatusMessage(tr("Command '%1' executed successfully.").arg(nodeName), false, 3000);
                     }
-                    delete errorMsg;
                 }
             );
         });
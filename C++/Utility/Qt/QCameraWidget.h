@@ -25,12 +25,16 @@
 #include <QSet>
 #include "Camera.h"
 
+#include <QCoreApplication>
+#include <QMetaObject>
+#include <QPointer>
 #include <QThread>
 
 #include <atomic>
 #include <cstddef>
 #include <memory>
 #include <mutex>
+#include <optional>
 
 class QCameraWidget : public QWidget
 {
@@ -74,7 +78,6 @@ private:
     Camera::CallbackId _nodeCallbackId = 0;
     QThread *_connectionThread = nullptr;
     QThread *_refreshThread = nullptr;
-    QSet<QThread*> _parameterThreads;
     bool _connectionOperationActive = false;
     bool _refreshOperationActive = false;
     bool _parameterWriteActive = false;
@@ -105,30 +108,39 @@ private:
     void updateGrabState(bool grabbing);
     void updateStatusLabel();
 
-    template <typename Func, typename Cleanup>
-    void runAsyncWrite(Func&& writeFunc, Cleanup&& cleanupFunc) {
+    /**
+     * Queues a write, or a command when `value` is empty, on the camera's parameter
+     * writer. `cleanupFunc(success, error)` runs on the GUI thread for the write
+     * that reached the device; writes superseded by a newer value are skipped.
+     */
+    template <typename Cleanup>
+    void runParameterWrite(const QString& nodeName, std::optional<ParameterWriter::Value> value, Cleanup&& cleanupFunc) {
+        if (!_camera) return;
         ++_pendingParameterWrites;
         _parameterWriteActive = true;
         updateStatusLabel();
-        const auto success = std::make_shared<bool>(false);
-        QThread* worker = QThread::create([writeFunc, success]() {
-            *success = writeFunc();
-        });
-        worker->setParent(this);
-        _parameterThreads.insert(worker);
-        connect(worker, &QThread::finished, this, [this, success, cleanupFunc, worker]() {
-            _parameterThreads.remove(worker);
-            if (_pendingParameterWrites > 0) {
-                --_pendingParameterWrites;
-            }
-            _parameterWriteActive = _pendingParameterWrites > 0;
-            if (!_shuttingDown) {
-                updateStatusLabel();
-                cleanupFunc(*success);
-            }
-            worker->deleteLater();
-        });
-        worker->start();
+        const QPointer<QCameraWidget> guard(this);
+        auto completion = [guard, cleanupFunc](const ParameterWriteResult& result) {
+            const bool success = result.success;
+            const bool coalesced = result.coalesced;
+            const QString error = QString::fromStdString(result.error);
+            QMetaObject::invokeMethod(qApp, [guard, cleanupFunc, success, coalesced, error]() {
+                if (!guard) return;
+                if (guard->_pendingParameterWrites > 0) {
+                    --guard->_pendingParameterWrites;
+                }
+                guard->_parameterWriteActive = guard->_pendingParameterWrites > 0;
+                if (guard->_shuttingDown) return;
+                guard->updateStatusLabel();
+                if (!coalesced) cleanupFunc(success, error);
+            }, Qt::QueuedConnection);
+        };
+        auto& writer = _camera->parameterWriter();
+        if (value) {
+            writer.write(nodeName.toStdString(), std::move(*value), std::move(completion));
+        } else {
+            writer.execute(nodeName.toStdString(), std::move(completion));
+        }
     }
 };
 #endif
@@ -12,6 +12,8 @@
 #include <pylon/ImageFormatConverter.h>
 #include <pylon/PylonImage.h>
 
+#include "TraceRecorder.h"
+
 #ifdef QT_GUI_LIB
 #include <QImage>
 
@@ -171,6 +173,7 @@ inline QImage copyRawImage(const Pylon::CPylonImage& pylonImg, const QImage::For
 
 inline QImage convertPylonImageToQImage(Pylon::CPylonImage pylonImg)
 {
+    CAMERA_TRACE_SCOPE("convertPylonImageToQImage");
     if(pylonImg.GetWidth() == 0 || pylonImg.GetHeight() == 0 || pylonImg.GetBuffer() == nullptr){
         return {};
     }